@@ -14,4 +14,7 @@ BinaryNodeTree<ItemType>::BinaryNode::BinaryNode(const ItemType& anItem,
     this->item = anItem;
     this->leftChildPtr = leftPtr;
     this->rightChildPtr = rightPtr;
+    this->flipped = false;
+    this->subtreeHash[0] = BinaryNodeTree<ItemType>::combineHash(*this, false);
+    this->subtreeHash[1] = BinaryNodeTree<ItemType>::combineHash(*this, true);
 }
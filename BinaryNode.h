@@ -19,6 +19,7 @@
 #ifndef BINARY_NODE_
 #define BINARY_NODE_
 
+#include <cstddef>
 #include <memory>
 #include "BinaryNodeTree.h"
 
@@ -37,6 +38,14 @@ public:
     BinaryNodePtr leftChildPtr;
     BinaryNodePtr rightChildPtr;
     
+    // Merkle-style hash of the item and both subtrees; refreshed by
+    // every mutator on its way back up the tree. Index 1 holds the hash
+    // of the mirrored subtree.
+    std::size_t subtreeHash[2];
+    
+    // Pending flip: when set, this subtree is read mirrored.
+    bool flipped;
+    
     BinaryNode(const ItemType& anItem,
                BinaryNodePtr leftPtr = nullptr,
                BinaryNodePtr rightPtr = nullptr);
@@ -20,9 +20,16 @@
 #include <iostream>
 #include <memory>
 #include <new>
+#include <optional>
 #include <iomanip>
 #include <climits>
 #include <iterator>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "PrecondViolatedExcep.h"
 #include "NotFoundException.h"
@@ -32,51 +39,113 @@
 //////////////////////////////////////////////////////////////
 
 template <typename ItemType>
-int BinaryNodeTree<ItemType>::getHeightHelper(BinaryNodePtr subTreePtr) const {
+int BinaryNodeTree<ItemType>::getHeightHelper(NodeView subTree) const {
     
     int height(0);
+    statsRecorder.heightRecomputed();
     
-    if (subTreePtr) {
-        height = 1 + std::max(getHeightHelper(subTreePtr->leftChildPtr),
-                              getHeightHelper(subTreePtr->rightChildPtr) );
+    if (subTree) {
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        height = 1 + std::max(getHeightHelper(subTree.left() ),
+                              getHeightHelper(subTree.right() ) );
     }
     return height;
 }
 
 template <typename ItemType>
-int BinaryNodeTree<ItemType>::getNumberOfNodesHelper(BinaryNodePtr subTreePtr) const {
+int BinaryNodeTree<ItemType>::getNumberOfNodesHelper(NodeView subTree) const {
     
     int numNodes(0);
+    depthFirst<Enter>(subTree, [&numNodes](TraversalStage, NodeView) {
+        ++numNodes;
+    });
+    return numNodes;
+}
+
+template <typename ItemType>
+template <unsigned Stages, typename Visitor>
+void BinaryNodeTree<ItemType>::depthFirst(NodeView subTree, Visitor visit) const {
     
-    if (subTreePtr) {
-        numNodes = 1 +
-        getNumberOfNodesHelper(subTreePtr->leftChildPtr) +
-        getNumberOfNodesHelper(subTreePtr->rightChildPtr);
+    // A frame holds the node and the flip parity above it, so that a
+    // pushed child is not read until it is popped.
+    struct Frame {
+        BinaryNode* nodePtr;
+        bool mirrored;
+        TraversalStage stage;
+    };
+    struct DepthFirstTag {};
+    ScratchBuffer<std::vector<Frame>, DepthFirstTag> scratch;
+    auto& pending(scratch.get() );
+    
+    auto pushChild = [&pending](const NodeView& parent, bool right) {
+        auto childPtr(childOf(*parent.get(), parent.isMirrored(), right).get() );
+        if (childPtr) {
+            __builtin_prefetch(childPtr);
+            pending.push_back({childPtr, parent.isMirrored(), Enter});
+        }
+    };
+    
+    if (subTree) {
+        // Undo the fold of the root's own flag; NodeView reapplies it.
+        pending.push_back({subTree.get(), subTree.isMirrored() != subTree.get()->flipped, Enter});
+    }
+    while (!pending.empty() ) {
+        statsRecorder.reachedDepth(static_cast<unsigned int>(pending.size() ) );
+        auto frame(pending.back() );
+        pending.pop_back();
+        
+        if (frame.stage != Enter) {
+            visit(frame.stage, NodeView(frame.nodePtr, frame.mirrored) );
+            continue;
+        }
+        
+        // Walk down the left spine without pushing it. Each node
+        // leaves behind, in pop order: Between, the right child, and
+        // Leave, as far as Stages needs them.
+        while (frame.nodePtr) {
+            const NodeView node(frame.nodePtr, frame.mirrored);
+            statsRecorder.nodeVisited();
+            if (Stages & Enter) {
+                visit(Enter, node);
+            }
+            if (Stages & Leave) {
+                pending.push_back({frame.nodePtr, frame.mirrored, Leave});
+            }
+            pushChild(node, true);
+            if (Stages & Between) {
+                pending.push_back({frame.nodePtr, frame.mirrored, Between});
+            }
+            frame = {childOf(*node.get(), node.isMirrored(), false).get(), node.isMirrored(), Enter};
+        }
     }
-    return numNodes;
 }
 
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
-BinaryNodeTree<ItemType>::balancedAdd(BinaryNodePtr subTreePtr,
-                                      BinaryNodePtr newNodePtr) {
+BinaryNodeTree<ItemType>::balancedAdd(const BinaryNodePtr& subTreePtr,
+                                      const BinaryNodePtr& newNodePtr,
+                                      bool exclusive,
+                                      bool mirrored) {
     
     auto returnPtr(newNodePtr);
     
     if (subTreePtr) {
-        auto leftPtr(subTreePtr->leftChildPtr);
-        auto rightPtr(subTreePtr->rightChildPtr);
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        returnPtr = ownedNode(subTreePtr, exclusive);
+        bool nodeMirrored(mirrored != returnPtr->flipped);
+        auto& leftPtr(childSlot(*returnPtr, nodeMirrored, false) );
+        auto& rightPtr(childSlot(*returnPtr, nodeMirrored, true) );
         
-        if (getHeightHelper(leftPtr) > getHeightHelper(rightPtr) ) {
-            subTreePtr->rightChildPtr = balancedAdd(rightPtr,
-                                                    newNodePtr);
+        if (getHeightHelper(NodeView(leftPtr.get(), nodeMirrored) ) >
+            getHeightHelper(NodeView(rightPtr.get(), nodeMirrored) ) ) {
+            rightPtr = balancedAdd(rightPtr, newNodePtr, true, nodeMirrored);
         }
         else {
-            subTreePtr->leftChildPtr = balancedAdd(leftPtr,
-                                                   newNodePtr);
+            leftPtr = balancedAdd(leftPtr, newNodePtr, true, nodeMirrored);
         }
-        
-        returnPtr = subTreePtr;
+        refreshHash(returnPtr);
     }
     
     return returnPtr;
@@ -84,33 +153,39 @@ BinaryNodeTree<ItemType>::balancedAdd(BinaryNodePtr subTreePtr,
 
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
-BinaryNodeTree<ItemType>::moveValuesUpTree(BinaryNodePtr subTreePtr) {
+BinaryNodeTree<ItemType>::moveValuesUpTree(const BinaryNodePtr& subTreePtr,
+                                           bool exclusive,
+                                           bool mirrored) {
     
     BinaryNodePtr returnPtr;
+    TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+    statsRecorder.nodeVisited();
     
-    if (isLeaf(subTreePtr) ) {
-        subTreePtr.reset();
-    }
-    else {
-        auto leftPtr(subTreePtr->leftChildPtr);
-        auto rightPtr(subTreePtr->rightChildPtr);
+    if (!isLeaf(subTreePtr) ) {
+        returnPtr = ownedNode(subTreePtr, exclusive);
+        bool nodeMirrored(mirrored != returnPtr->flipped);
+        auto& leftPtr(childSlot(*returnPtr, nodeMirrored, false) );
+        auto& rightPtr(childSlot(*returnPtr, nodeMirrored, true) );
         
-        if (getHeightHelper(leftPtr) > getHeightHelper(rightPtr) ) {
-            subTreePtr->item =  leftPtr->item;
-            subTreePtr->leftChildPtr = moveValuesUpTree(leftPtr);
+        if (getHeightHelper(NodeView(leftPtr.get(), nodeMirrored) ) >
+            getHeightHelper(NodeView(rightPtr.get(), nodeMirrored) ) ) {
+            returnPtr->item =  leftPtr->item;
+            statsRecorder.itemCopied();
+            leftPtr = moveValuesUpTree(leftPtr, true, nodeMirrored);
         }
         else {
-            subTreePtr->item = rightPtr->item;
-            subTreePtr->rightChildPtr = moveValuesUpTree(rightPtr);
+            returnPtr->item = rightPtr->item;
+            statsRecorder.itemCopied();
+            rightPtr = moveValuesUpTree(rightPtr, true, nodeMirrored);
         }
-        
-        returnPtr = subTreePtr;
+        refreshHash(returnPtr);
     }
     
     return returnPtr;
 }
 
-/** Depth-first search of tree for item.
+/** Depth-first search of tree for item. Nodes are only cloned once the
+ *  target has been found, and then only along the path to it.
  *
  *  @param subTreePtr The tree to search.
  *
@@ -118,75 +193,218 @@ BinaryNodeTree<ItemType>::moveValuesUpTree(BinaryNodePtr subTreePtr) {
  *
  *  @param success Communicate to client whether we found the target.
  *
- *  @return A pointer to the node containing the target. */
+ *  @param exclusive True if no other tree shares the path down to
+ *         subTreePtr.
+ *
+ *  @param mirrored True if an odd number of flips is pending above
+ *         subTreePtr.
+ *
+ *  @return A pointer to the (possibly cloned) subtree with the target
+ *          removed. */
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
-BinaryNodeTree<ItemType>::removeValue(BinaryNodePtr subTreePtr,
+BinaryNodeTree<ItemType>::removeValue(const BinaryNodePtr& subTreePtr,
                                       const ItemType& target,
-                                      bool& success) {
+                                      bool& success,
+                                      bool exclusive,
+                                      bool mirrored) {
     
-    BinaryNodePtr returnPtr;
+    if (!subTreePtr) {
+        return subTreePtr;
+    }
     
-    if(subTreePtr) {
-        if (subTreePtr->item == target) {
-            subTreePtr = moveValuesUpTree(subTreePtr);
-            success = true;
-        }
-        else {
-            subTreePtr->leftChildPtr = removeValue(subTreePtr->leftChildPtr,
-                                                   target,
-                                                   success);
-            if (!success) {
-                subTreePtr->rightChildPtr = removeValue(subTreePtr->rightChildPtr,
-                                                        target,
-                                                        success);
-            }
+    TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+    statsRecorder.nodeVisited();
+    if (Lookup::equal(Lookup::keyOf(subTreePtr->item), Lookup::keyOf(target) ) ) {
+        success = true;
+        return moveValuesUpTree(subTreePtr, exclusive, mirrored);
+    }
+    
+    bool nodeMirrored(mirrored != subTreePtr->flipped);
+    bool childExclusive(exclusive && subTreePtr.use_count() == 1);
+    for (bool right : {false, true}) {
+        auto newChildPtr(removeValue(childOf(*subTreePtr, nodeMirrored, right),
+                                     target,
+                                     success,
+                                     childExclusive,
+                                     nodeMirrored) );
+        if (success) {
+            auto returnPtr(ownedNode(subTreePtr, exclusive) );
+            childSlot(*returnPtr, nodeMirrored, right) = newChildPtr;
+            refreshHash(returnPtr);
+            return returnPtr;
         }
-        
-        returnPtr = subTreePtr;
     }
     
-    return returnPtr;
+    return subTreePtr;
+}
+
+/** Gives access to a node that may be modified without affecting any
+ *  other tree. Nodes are shared between copies of a tree until one of
+ *  them mutates; the node is cloned unless both the node and every
+ *  node above it belong to this tree alone.
+ *
+ *  @param nodePtr The node about to be modified.
+ *
+ *  @param exclusive True if no other tree shares the path down to
+ *         nodePtr.
+ *
+ *  @return nodePtr itself, or a shallow clone sharing its children. */
+template <typename ItemType>
+std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
+BinaryNodeTree<ItemType>::ownedNode(const BinaryNodePtr& nodePtr,
+                                    bool exclusive) const {
+    
+    if (exclusive && nodePtr.use_count() == 1) {
+        return nodePtr;
+    }
+    
+    statsRecorder.allocated();
+    statsRecorder.itemCopied();
+    return std::make_shared<BinaryNode>(*nodePtr);
 }
 
+// Clones every node still shared with another tree, so the whole tree
+// can be modified in place. Pending flips are left as they are.
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
-BinaryNodeTree<ItemType>::findNode(BinaryNodePtr subTreePtr,
-                                   const ItemType& target) const {
+BinaryNodeTree<ItemType>::unshareTree(const BinaryNodePtr& subTreePtr,
+                                      bool exclusive) const {
     
     BinaryNodePtr returnPtr;
     
     if (subTreePtr) {
-        if (subTreePtr->item == target) {
-            returnPtr = subTreePtr;
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        returnPtr = ownedNode(subTreePtr, exclusive);
+        returnPtr->leftChildPtr = unshareTree(returnPtr->leftChildPtr, true);
+        returnPtr->rightChildPtr = unshareTree(returnPtr->rightChildPtr, true);
+    }
+    
+    return returnPtr;
+}
+
+template <typename ItemType>
+template <typename KeyType>
+typename BinaryNodeTree<ItemType>::NodeView
+BinaryNodeTree<ItemType>::findNode(NodeView subTree,
+                                   const KeyType& key) const {
+    
+    NodeView returnView;
+    
+    if (subTree) {
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        if (Lookup::equal(Lookup::keyOf(subTree.item() ), key) ) {
+            returnView = subTree;
         }
         else {
-            returnPtr = findNode(subTreePtr->leftChildPtr,
-                                 target);
-            if (!returnPtr) {
-                returnPtr = findNode(subTreePtr->rightChildPtr,
-                                     target);
+            returnView = findNode(subTree.left(), key);
+            if (!returnView) {
+                returnView = findNode(subTree.right(), key);
             }
         }
     }
     
-    return returnPtr;
+    return returnView;
 }
 
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
 BinaryNodeTree<ItemType>::copyTree(const BinaryNodePtr& subTreePtr) const {
     
-    BinaryNodePtr newTreePtr;
+    // Copies are made children first; each finished subtree waits on
+    // copies, left below right, until its parent is copied.
+    std::vector<BinaryNodePtr> copies;
+    depthFirst<Leave>(NodeView(subTreePtr.get(), false),
+                      [this, &copies](TraversalStage, NodeView node) {
+        BinaryNodePtr rightPtr;
+        BinaryNodePtr leftPtr;
+        if (node.right() ) {
+            rightPtr = std::move(copies.back() );
+            copies.pop_back();
+        }
+        if (node.left() ) {
+            leftPtr = std::move(copies.back() );
+            copies.pop_back();
+        }
+        statsRecorder.allocated();
+        statsRecorder.itemCopied();
+        copies.push_back(std::make_shared<BinaryNode>(node.item(), leftPtr, rightPtr) );
+    });
     
-    // Copy tree nodes using a preorder traversal
-    if (subTreePtr) {
-        newTreePtr = std::make_shared<BinaryNode>(subTreePtr->item,
-                                                  copyTree(subTreePtr->leftChildPtr),
-                                                  copyTree(subTreePtr->rightChildPtr) );
+    return copies.empty() ? BinaryNodePtr() : copies.back();
+}
+
+//////////////////////////////////////////////////////////////
+//      Protected Hashing Sub-Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::hashItem(const ItemType& anItem) {
+    
+    if constexpr (hashesItems) {
+        return std::hash<ItemType>()(anItem);
+    }
+    else {
+        static_cast<void>(anItem);
+        return 0;
     }
+}
+
+template <typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::subtreeHashOf(const BinaryNodePtr& nodePtr,
+                                                    bool mirrored) {
+    
+    // Arbitrary non-zero marker so that an empty child differs from a
+    // child whose hash happens to be zero.
+    return nodePtr ? nodePtr->subtreeHash[mirrored] : 0x9e3779b97f4a7c15ULL;
+}
+
+/** Mixes the item hash with the child hashes. The children are mixed
+ *  with different constants so that mirrored subtrees hash apart.
+ *
+ *  @param node The node whose children's hashes are current.
+ *
+ *  @param mirrored True to hash the subtree as seen under an odd number
+ *         of pending flips.
+ *
+ *  @return The Merkle hash of the subtree rooted at node. */
+template <typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::combineHash(const BinaryNode& node,
+                                                  bool mirrored) {
+    
+    auto mix = [](unsigned long long h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    };
+    
+    bool nodeMirrored(mirrored != node.flipped);
+    unsigned long long h(mix(hashItem(node.item) ) );
+    h = mix(h ^ (subtreeHashOf(childOf(node, nodeMirrored, false), nodeMirrored)
+                 + 0x165667b19e3779f9ULL) );
+    h = mix(h ^ (subtreeHashOf(childOf(node, nodeMirrored, true), nodeMirrored)
+                 * 0x27d4eb2f165667c5ULL) );
+    return static_cast<std::size_t>(h);
+}
+
+template <typename ItemType>
+void BinaryNodeTree<ItemType>::refreshHash(const BinaryNodePtr& nodePtr) {
+    
+    refreshHash(nodePtr.get() );
+}
+
+template <typename ItemType>
+void BinaryNodeTree<ItemType>::refreshHash(BinaryNode* nodePtr) {
     
-    return newTreePtr;
+    if (nodePtr) {
+        nodePtr->subtreeHash[0] = combineHash(*nodePtr, false);
+        nodePtr->subtreeHash[1] = combineHash(*nodePtr, true);
+    }
 }
 
 //////////////////////////////////////////////////////////////
@@ -195,39 +413,51 @@ BinaryNodeTree<ItemType>::copyTree(const BinaryNodePtr& subTreePtr) const {
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::preorder(void visit(ItemType&),
-                                        BinaryNodePtr subTreePtr) {
+                                        NodeView subTree) {
     
-    if (subTreePtr) {
-        visit(subTreePtr->item);
-        
-        preorder(visit, subTreePtr->leftChildPtr);
-        preorder(visit, subTreePtr->rightChildPtr);
-    }
+    // visit may change the items, so hashes are refreshed on the way up.
+    depthFirst<Enter | Leave>(subTree, [visit](TraversalStage stage, NodeView node) {
+        if (stage == Enter) {
+            visit(node.item() );
+        }
+        else {
+            refreshHash(node.get() );
+        }
+    });
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::inorder(void visit(ItemType&),
-                                       BinaryNodePtr subTreePtr) {
+                                       NodeView subTree) {
     
-    if (subTreePtr) {
-        inorder(visit, subTreePtr->leftChildPtr);
-        
-        visit(subTreePtr->item);
-        
-        inorder(visit, subTreePtr->rightChildPtr);
-    }
+    depthFirst<Between | Leave>(subTree, [visit](TraversalStage stage, NodeView node) {
+        if (stage == Between) {
+            visit(node.item() );
+        }
+        else {
+            refreshHash(node.get() );
+        }
+    });
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::postorder(void visit(ItemType&),
-                                         BinaryNodePtr subTreePtr) {
+                                         NodeView subTree) {
     
-    if (subTreePtr) {
-        postorder(visit, subTreePtr->leftChildPtr);
-        postorder(visit, subTreePtr->rightChildPtr);
-        
-        visit(subTreePtr->item);
-    }
+    depthFirst<Leave>(subTree, [visit](TraversalStage, NodeView node) {
+        visit(node.item() );
+        refreshHash(node.get() );
+    });
+}
+
+template <typename ItemType>
+void BinaryNodeTree<ItemType>::refreshHashes(NodeView subTree) {
+    
+    // Iterative, so that a degenerate tree cannot overflow the stack
+    // while MutableVisitGuard unwinds.
+    depthFirst<Leave>(subTree, [](TraversalStage, NodeView node) {
+        refreshHash(node.get() );
+    });
 }
 
 //////////////////////////////////////////////////////////////
@@ -235,22 +465,102 @@ void BinaryNodeTree<ItemType>::postorder(void visit(ItemType&),
 //////////////////////////////////////////////////////////////
 
 template <typename ItemType>
-bool BinaryNodeTree<ItemType>::isLeaf(BinaryNodePtr nodePtr) const {
+bool BinaryNodeTree<ItemType>::isLeaf(const BinaryNodePtr& nodePtr) const {
     
     return !nodePtr->leftChildPtr && !nodePtr->rightChildPtr;
 }
 
+/** Reads a child through pending flips: under an odd number of flips
+ *  the physical right child is the logical left one.
+ *
+ *  @param node The parent node.
+ *
+ *  @param mirrored True if the parent is seen mirrored, i.e. the flips
+ *         pending above it and its own flag add up to an odd number.
+ *
+ *  @param right True for the logical right child, false for the left.
+ *
+ *  @return The physical child pointer holding that logical child. */
+template <typename ItemType>
+const std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>&
+BinaryNodeTree<ItemType>::childOf(const BinaryNode& node,
+                                  bool mirrored,
+                                  bool right) {
+    
+    return (mirrored != right) ? node.rightChildPtr : node.leftChildPtr;
+}
+
+template <typename ItemType>
+std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>&
+BinaryNodeTree<ItemType>::childSlot(BinaryNode& node,
+                                    bool mirrored,
+                                    bool right) {
+    
+    return (mirrored != right) ? node.rightChildPtr : node.leftChildPtr;
+}
+
+/** Folds a tree-level flip into the flag of the root node, cloning the
+ *  root if it is shared, so that the subtree reads the same without
+ *  the tree around it.
+ *
+ *  @param subTreePtr The root of the subtree.
+ *
+ *  @param mirrored True if a flip is pending above subTreePtr.
+ *
+ *  @return A root whose own flag carries the pending flip. */
 template <typename ItemType>
 std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
-BinaryNodeTree<ItemType>::getRootPtr() const {
+BinaryNodeTree<ItemType>::pushDownFlip(const BinaryNodePtr& subTreePtr,
+                                       bool mirrored) const {
+    
+    if (!subTreePtr || !mirrored) {
+        return subTreePtr;
+    }
+    
+    auto returnPtr(ownedNode(subTreePtr, false) );
+    returnPtr->flipped = !returnPtr->flipped;
+    refreshHash(returnPtr);
+    return returnPtr;
+}
+
+template <typename ItemType>
+typename BinaryNodeTree<ItemType>::NodeView
+BinaryNodeTree<ItemType>::rootView() const {
+    
+    return NodeView(rootPtr.get(), mirrored);
+}
+
+// Children of the returned root must still be read through childOf,
+// since flips below the root are applied lazily. Pushing the flip
+// down changes only how the tree is stored, not what it holds, so
+// the version is left alone.
+template <typename ItemType>
+std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
+BinaryNodeTree<ItemType>::getRootPtr() {
     
+    if (rootPtr && mirrored) {
+        rootPtr = ownedNode(rootPtr, true);
+        rootPtr->flipped = !rootPtr->flipped;
+        refreshHash(rootPtr);
+    }
+    mirrored = false;
     return rootPtr;
 }
 
+template <typename ItemType>
+std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
+BinaryNodeTree<ItemType>::getRootPtr() const {
+    
+    return pushDownFlip(rootPtr, mirrored);
+}
+
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::setRootPtr(BinaryNodePtr newRootPtr) {
     
     rootPtr = newRootPtr;
+    mirrored = false;
+    touch();
+    rebuildMembershipFilter();
 }
 
 //////////////////////////////////////////////////////////////
@@ -264,27 +574,39 @@ void BinaryNodeTree<ItemType>::setRootPtr(BinaryNodePtr newRootPtr) {
 template <typename ItemType>
 BinaryNodeTree<ItemType>::BinaryNodeTree(const ItemType& rootItem)
 : rootPtr(std::make_shared<BinaryNode>(rootItem) ) {
+    
+    statsRecorder.allocated();
 }
 
 template <typename ItemType>
 BinaryNodeTree<ItemType>::BinaryNodeTree(const ItemType& rootItem,
                                          const std::shared_ptr<BinaryNodeTree<ItemType>> leftTreePtr,
-                                         const std::shared_ptr<BinaryNodeTree<ItemType>> rightTreePtr)
-: rootPtr(std::make_shared<BinaryNode>(rootItem,
-                                       copyTree(leftTreePtr->rootPtr),
-                                       copyTree(rightTreePtr->rootPtr)) ) {
+                                         const std::shared_ptr<BinaryNodeTree<ItemType>> rightTreePtr) {
+    
+    // Built here rather than in the initializer list, since
+    // pushDownFlip counts into statsRecorder, which is constructed
+    // after rootPtr. Both subtrees stay shared with their trees until
+    // either side mutates them.
+    rootPtr = std::make_shared<BinaryNode>(rootItem,
+                                           pushDownFlip(leftTreePtr->rootPtr,
+                                                        leftTreePtr->mirrored),
+                                           pushDownFlip(rightTreePtr->rootPtr,
+                                                        rightTreePtr->mirrored) );
+    statsRecorder.allocated();
 }
 
 template <typename ItemType>
-BinaryNodeTree<ItemType>::BinaryNodeTree(const BinaryNodeTree<ItemType>& treePtr) {
+BinaryNodeTree<ItemType>::BinaryNodeTree(const BinaryNodeTree<ItemType>& treePtr)
+: rootPtr(treePtr.rootPtr),
+  mirrored(treePtr.mirrored),
+  membershipFilter(treePtr.membershipFilter),
+  accessCounts(treePtr.accessCounts),
+  lookupsUntilPromotion(treePtr.lookupsUntilPromotion),
+  promotionPeriod(treePtr.promotionPeriod) {
     
-    try {
-        rootPtr = copyTree(treePtr.rootPtr);
-    }
-    catch (const std::bad_alloc&) {
-        clear();
-        throw;
-    }
+    // Copy-on-write: the nodes are shared until one of the trees
+    // mutates, and then only the touched path is cloned.
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Copy);
 }
 
 //////////////////////////////////////////////////////////////
@@ -300,19 +622,27 @@ bool BinaryNodeTree<ItemType>::isEmpty() const {
 template <typename ItemType>
 int BinaryNodeTree<ItemType>::getHeight() const {
     
-    return getHeightHelper(rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Height);
+    return getHeightHelper(rootView() );
 }
 
 template <typename ItemType>
 int BinaryNodeTree<ItemType>::getNumberOfNodes() const {
     
-    return getNumberOfNodesHelper(rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::NodeCount);
+    return getNumberOfNodesHelper(rootView() );
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::clear() {
     
     rootPtr.reset();
+    mirrored = false;
+    touch();
+    accessCounts.clear();
+    if (auto filter = writableFilter() ) {
+        filter->clear();
+    }
 }
 
 template <typename ItemType>
@@ -325,65 +655,143 @@ ItemType BinaryNodeTree<ItemType>::getRootData() const {
         throw PrecondViolatedExcep(message);
     }
     
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    statsRecorder.itemCopied();
     return rootPtr->item;
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::setRootData(const ItemType& newItem) {
     
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    statsRecorder.itemCopied();
+    touch();
     if (isEmpty() ) {
         try {
             rootPtr = std::make_shared<BinaryNode>(newItem);
+            statsRecorder.allocated();
         }
         catch (const std::bad_alloc&) {
             // What should we do with this? Return something? Throw a
             // different type of exception? Crash?
+            return;
         }
     }
     else {
+        rootPtr = ownedNode(rootPtr, true);
+        if (auto filter = writableFilter() ) {
+            filter->erase(keyHash(rootPtr->item) );
+        }
         rootPtr->item = newItem;
+        refreshHash(rootPtr);
+    }
+    if (auto filter = writableFilter() ) {
+        filter->insert(keyHash(newItem) );
     }
 }
 
 template <typename ItemType>
 bool BinaryNodeTree<ItemType>::add(const ItemType& newData) {
     
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Add);
     bool canAdd(true);
+    touch();
     try {
+        statsRecorder.allocated();
+        statsRecorder.itemCopied();
         rootPtr = balancedAdd(rootPtr,
-                              std::make_shared<BinaryNode>(newData) );
+                              std::make_shared<BinaryNode>(newData),
+                              true,
+                              mirrored);
     }
     catch (const std::bad_alloc&) {
         canAdd = false;
     }
+    if (canAdd) {
+        if (auto filter = writableFilter() ) {
+            filter->insert(keyHash(newData) );
+        }
+    }
     return canAdd;
 }
 
 template <typename ItemType>
 bool BinaryNodeTree<ItemType>::remove(const ItemType& target) {
     
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Remove);
     bool isSuccessful(false);
-    rootPtr = removeValue(rootPtr, target, isSuccessful);
+    rootPtr = removeValue(rootPtr, target, isSuccessful, true, mirrored);
+    if (isSuccessful) {
+        touch();
+        if (auto filter = writableFilter() ) {
+            filter->erase(keyHash(target) );
+        }
+    }
     return isSuccessful;
 }
 
 template <typename ItemType>
 ItemType BinaryNodeTree<ItemType>::getEntry(const ItemType& anEntry) const {
     
-    auto binaryNodePtr(findNode(rootPtr, anEntry) );
+    auto entry(tryGetEntryByKey(Lookup::keyOf(anEntry) ) );
     
-    if (!binaryNodePtr) {
+    if (!entry) {
         std::string message("BinaryNodeTree::getEntry: Entry ");
         message += "not found in this tree.";
         throw NotFoundException(message);
     }
-    return binaryNodePtr->item;
+    return *entry;
 }
 
 template <typename ItemType>
 bool BinaryNodeTree<ItemType>::contains(const ItemType& anEntry) const {
     
-    return findNode(rootPtr, anEntry) != nullptr;
+    return containsKey(Lookup::keyOf(anEntry) );
+}
+
+template <typename ItemType>
+template <typename KeyType, typename>
+bool BinaryNodeTree<ItemType>::contains(const KeyType& key) const {
+    
+    return containsKey(key);
+}
+
+template <typename ItemType>
+template <typename KeyType, typename>
+ItemType BinaryNodeTree<ItemType>::getEntry(const KeyType& key) const {
+    
+    auto entry(tryGetEntryByKey(key) );
+    
+    if (!entry) {
+        std::string message("BinaryNodeTree::getEntry: Entry ");
+        message += "not found in this tree.";
+        throw NotFoundException(message);
+    }
+    return *entry;
+}
+
+template <typename ItemType>
+template <typename KeyType>
+bool BinaryNodeTree<ItemType>::containsKey(const KeyType& key) const {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Contains);
+    if (!mayContain(key) ) {
+        return false;
+    }
+    // The SIMD scan compares whole items with ==, so it only stands
+    // in for the default lookup.
+    if constexpr (std::is_arithmetic<ItemType>::value &&
+                  std::is_same<KeyType, ItemType>::value &&
+                  std::is_base_of<IdentityLookup<ItemType>, Lookup>::value) {
+        if (isFlattened() ) {
+            const bool found(simdContains(flatItems.data(), flatItems.size(), key) );
+            recordLookup(found ? &key : nullptr);
+            return found;
+        }
+    }
+    auto nodeView(findNode(rootView(), key) );
+    recordLookup(nodeView ? &nodeView.item() : nullptr);
+    return static_cast<bool>(nodeView);
 }
 
 //////////////////////////////////////////////////////////////
@@ -393,19 +801,128 @@ bool BinaryNodeTree<ItemType>::contains(const ItemType& anEntry) const {
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::preorderTraverse(void visit(ItemType&) ) {
     
-    preorder(visit, rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    // visit may change any item, so no node may stay shared.
+    rootPtr = unshareTree(rootPtr, true);
+    touch();
+    MutableVisitGuard guard(*this);
+    preorder(visit, rootView() );
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::inorderTraverse(void visit(ItemType&) ) {
     
-    inorder(visit, rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    // visit may change any item, so no node may stay shared.
+    rootPtr = unshareTree(rootPtr, true);
+    touch();
+    MutableVisitGuard guard(*this);
+    inorder(visit, rootView() );
 }
 
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::postorderTraverse(void visit(ItemType&) ) {
     
-    postorder(visit, rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    // visit may change any item, so no node may stay shared.
+    rootPtr = unshareTree(rootPtr, true);
+    touch();
+    MutableVisitGuard guard(*this);
+    postorder(visit, rootView() );
+}
+
+template <typename ItemType>
+void BinaryNodeTree<ItemType>::levelorderTraverse(void visit(ItemType&) ) {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    rootPtr = unshareTree(rootPtr, true);
+    touch();
+    MutableVisitGuard guard(*this);
+    
+    // The queue's buffer stays with the thread, so repeated traversals
+    // stop allocating once it has grown to the widest level.
+    struct LevelQueueTag {};
+    ScratchBuffer<RingQueue<NodeView>, LevelQueueTag> scratch;
+    auto& queue(scratch.get() );
+    
+    if (rootPtr) {
+        queue.enqueue(rootView() );
+    }
+    while (!queue.isEmpty() ) {
+        auto node(queue.peekFront() );
+        queue.dequeue();
+        statsRecorder.nodeVisited();
+        statsRecorder.reachedDepth(static_cast<unsigned int>(queue.size() ) );
+        
+        visit(node.item() );
+        
+        if (node.left() ) {
+            queue.enqueue(node.left() );
+        }
+        if (node.right() ) {
+            queue.enqueue(node.right() );
+        }
+    }
+    
+    // visit may have changed any item.
+    refreshHashes(rootView() );
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void BinaryNodeTree<ItemType>::levelorderFrontiers(Visitor visit) const {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    struct FrontierTag {};
+    struct NextFrontierTag {};
+    struct FrontierItemsTag {};
+    ScratchBuffer<std::vector<NodeView>, FrontierTag> frontierScratch;
+    ScratchBuffer<std::vector<NodeView>, NextFrontierTag> nextScratch;
+    ScratchBuffer<std::vector<ItemType>, FrontierItemsTag> itemScratch;
+    auto& frontier(frontierScratch.get() );
+    auto& next(nextScratch.get() );
+    auto& items(itemScratch.get() );
+    
+    if (rootPtr) {
+        frontier.push_back(rootView() );
+    }
+    for (int depth(0); !frontier.empty(); ++depth) {
+        items.clear();
+        next.clear();
+        for (auto node : frontier) {
+            statsRecorder.nodeVisited();
+            items.push_back(node.item() );
+            if (node.left() ) {
+                next.push_back(node.left() );
+            }
+            if (node.right() ) {
+                next.push_back(node.right() );
+            }
+        }
+        visit(depth, static_cast<const ItemType*>(items.data() ), items.size() );
+        frontier.swap(next);
+    }
+}
+
+template <typename ItemType>
+std::vector<typename BinaryNodeTree<ItemType>::LevelStats>
+BinaryNodeTree<ItemType>::levelStats() const {
+    
+    std::vector<LevelStats> stats;
+    levelorderFrontiers([&stats](int, const ItemType* items, std::size_t count) {
+        LevelStats level{count, items[0], items[0], items[0]};
+        for (std::size_t i(1); i < count; ++i) {
+            level.sum = level.sum + items[i];
+            if (items[i] < level.min) {
+                level.min = items[i];
+            }
+            if (level.max < items[i]) {
+                level.max = items[i];
+            }
+        }
+        stats.push_back(level);
+    });
+    return stats;
 }
 
 //////////////////////////////////////////////////////////////
@@ -416,22 +933,136 @@ template <typename ItemType>
 BinaryNodeTree<ItemType>&
 BinaryNodeTree<ItemType>::operator=(const BinaryNodeTree<ItemType>& rhs) {
     
-    auto oldTreePtr(rootPtr);
-    
     if (this != &rhs) {
-        try {
-            rootPtr = copyTree(rhs.rootPtr);
-            oldTreePtr.reset();
+        // Copy-on-write, as in the copy constructor.
+        TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Copy);
+        rootPtr = rhs.rootPtr;
+        mirrored = rhs.mirrored;
+        membershipFilter = rhs.membershipFilter;
+        accessCounts = rhs.accessCounts;
+        lookupsUntilPromotion = rhs.lookupsUntilPromotion;
+        promotionPeriod = rhs.promotionPeriod;
+        touch();
+    }
+    
+    return *this;
+}
+
+template <typename ItemType>
+bool BinaryNodeTree<ItemType>::operator==(const BinaryNodeTree<ItemType>& rhs) const {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    if (hash() != rhs.hash() ) {
+        return false;
+    }
+    
+    // Equal hashes: confirm with a lockstep walk that stops at the
+    // first mismatch.
+    std::vector<std::pair<NodeView, NodeView>> pending;
+    pending.emplace_back(rootView(), rhs.rootView() );
+    while (!pending.empty() ) {
+        auto nodes(pending.back() );
+        pending.pop_back();
+        
+        if (!nodes.first || !nodes.second) {
+            if (nodes.first || nodes.second) {
+                return false;
+            }
+            continue;
         }
-        catch (const std::bad_alloc&) {
-            rootPtr.reset();
-            rootPtr = oldTreePtr;
-            throw;
+        statsRecorder.nodeVisited();
+        if (nodes.first == nodes.second) {
+            continue; // Shared subtree.
         }
+        if (!(nodes.first.item() == nodes.second.item() ) ) {
+            return false;
+        }
+        pending.emplace_back(nodes.first.right(), nodes.second.right() );
+        pending.emplace_back(nodes.first.left(), nodes.second.left() );
     }
+    return true;
+}
+
+template <typename ItemType>
+bool BinaryNodeTree<ItemType>::operator!=(const BinaryNodeTree<ItemType>& rhs) const {
     
-    return *this;
+    return !(*this == rhs);
+}
+
+//////////////////////////////////////////////////////////////
+//      Structural Equality, Hashing and Diff
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool BinaryNodeTree<ItemType>::sameShape(const BinaryNodeTree<ItemType>& other) const {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    std::vector<std::pair<NodeView, NodeView>> pending;
+    pending.emplace_back(rootView(), other.rootView() );
+    while (!pending.empty() ) {
+        auto nodes(pending.back() );
+        pending.pop_back();
+        
+        if (!nodes.first || !nodes.second) {
+            if (nodes.first || nodes.second) {
+                return false;
+            }
+            continue;
+        }
+        statsRecorder.nodeVisited();
+        pending.emplace_back(nodes.first.right(), nodes.second.right() );
+        pending.emplace_back(nodes.first.left(), nodes.second.left() );
+    }
+    return true;
+}
+
+template <typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::hash() const {
+    
+    return subtreeHashOf(rootPtr, mirrored);
+}
+
+template <typename ItemType>
+std::vector<std::string>
+BinaryNodeTree<ItemType>::diff(const BinaryNodeTree<ItemType>& other) const {
+    
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    std::vector<std::string> changedPaths;
+    
+    struct Pending {
+        NodeView mine;
+        NodeView theirs;
+        std::string path;
+    };
+    std::vector<Pending> pending;
+    pending.push_back({rootView(), other.rootView(), std::string()});
+    while (!pending.empty() ) {
+        auto next(std::move(pending.back() ) );
+        pending.pop_back();
+        
+        if (!next.mine && !next.theirs) {
+            continue;
+        }
+        if (!next.mine || !next.theirs) {
+            changedPaths.push_back(std::move(next.path) );
+            continue;
+        }
+        statsRecorder.nodeVisited();
+        if (next.mine == next.theirs ||
+            (hashesItems && next.mine.hash() == next.theirs.hash() ) ) {
+            continue;
+        }
+        if (!(next.mine.item() == next.theirs.item() ) ) {
+            changedPaths.push_back(std::move(next.path) );
+            continue;
+        }
+        // Same item, so the difference lies in the children.
+        pending.push_back({next.mine.right(), next.theirs.right(), next.path + 'R'});
+        pending.push_back({next.mine.left(), next.theirs.left(), next.path + 'L'});
+    }
+    return changedPaths;
 }
+
 //////////////////////////////////////////////////////////////
 //      Display contents of the Binary Tree
 //////////////////////////////////////////////////////////////
@@ -440,88 +1071,62 @@ void BinaryNodeTree<ItemType>::CallDisplay(){
     display(rootPtr);
 }
 template <typename ItemType>
-void BinaryNodeTree<ItemType>::display(BinaryNodeTree::BinaryNodePtr RootPtrSit){
+void BinaryNodeTree<ItemType>::display(const BinaryNodePtr& RootPtrSit){
     if (RootPtrSit == nullptr){
         return;
     }
-    treeHelperDisplay(rootPtr, 0);
+    treeHelperDisplay(rootView(), 0);
 }
 template <typename ItemType>
-void BinaryNodeTree<ItemType>::treeHelperDisplay(BinaryNodePtr node,int height ) const{
-    if (node->leftChildPtr != nullptr){ // is left child
-        treeHelperDisplay(node->leftChildPtr, height+1);
+void BinaryNodeTree<ItemType>::treeHelperDisplay(NodeView node,int height ) const{
+    if (node.left()){ // is left child
+        treeHelperDisplay(node.left(), height+1);
     }
     
     for(int i(0); i<=height; i++){
         std::cout<<" ";
     }
-        std::cout<< node->item << "\n";
-    if (node->rightChildPtr != nullptr){// is right child
-        treeHelperDisplay(node->rightChildPtr, height+1);
+        std::cout<< node.item() << "\n";
+    if (node.right()){// is right child
+        treeHelperDisplay(node.right(), height+1);
     }
 }
 
 //////////////////////////////////////////////////////////////
 // Flip (or mirror) the nodes in this binary tree left-to-right.
+// The flip is lazy: only the tree-level mirror flag changes, and every
+// reader sees the children swapped through childOf.
 //////////////////////////////////////////////////////////////
 template <typename ItemType>
 void BinaryNodeTree<ItemType>::flip(){
-    fliphelper(rootPtr);
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Flip);
+    mirrored = !mirrored;
+    touch();
 }
+//////////////////////////////////////////////////////////////
+//Test if this binary tree contains a binary search tree.
+//////////////////////////////////////////////////////////////
 template<typename ItemType>
-void BinaryNodeTree<ItemType>::fliphelper(BinaryNodePtr rootPtr){
-    if (rootPtr!= nullptr){// is right child
-        BinaryNodePtr temp;
-        temp = rootPtr->rightChildPtr;
-        rootPtr->rightChildPtr = rootPtr->leftChildPtr;
-        rootPtr->leftChildPtr = temp;
-        fliphelper(rootPtr->rightChildPtr);
-        fliphelper(rootPtr->leftChildPtr);
-    }
-//    long unsigned int height = getHeight();
-//    ItemType pathArray[height];
-//    flipHelperDisplay(rootPtr, pathArray, indexNum);
+bool BinaryNodeTree<ItemType>::BST(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    bool value;
+    value = BSTHelper(rootView(), INT_MIN, INT_MAX);
+    return value;
 }
 template<typename ItemType>
-void BinaryNodeTree<ItemType>::flipHelperDisplay(BinaryNodePtr nodePtr,ItemType arry[], unsigned long int numCount){
-    arry[indexNum] = nodePtr->item;
-    ++indexNum;
-    if (nodePtr->leftChildPtr != nullptr){ // is left child
-        printArray(arry, indexNum);
-        flipHelperDisplay(nodePtr->leftChildPtr, arry,++numCount);
-        --numCount;
-    }
-    for(int i(0); i<=numCount; i++){
-        std::cout<<"|";
-    }
-    if (nodePtr->rightChildPtr != nullptr){ // is right child
-        printArray(arry, indexNum);
-        flipHelperDisplay(nodePtr->rightChildPtr, arry,++numCount);
-        --numCount;
-    }
-    if(nodePtr->leftChildPtr == nullptr && nodePtr->rightChildPtr == nullptr){
-        printArray(arry,indexNum);
-    }
-}
-//////////////////////////////////////////////////////////////
-//Test if this binary tree contains a binary search tree.
-//////////////////////////////////////////////////////////////
-template<typename ItemType>
-bool BinaryNodeTree<ItemType>::BST(){
-    bool value;
-    value = BSTHelper(rootPtr, INT_MIN, INT_MAX);
-    return value;
-}
-template<typename ItemType>
-bool BinaryNodeTree<ItemType>::BSTHelper(BinaryNodePtr rootPtr, int min, int max){
-    if(rootPtr == NULL){
+bool BinaryNodeTree<ItemType>::BSTHelper(NodeView node, long long min, long long max){
+    if(!node){
         return 1;
     }
     else{
-        if(rootPtr->item>max || rootPtr->item < min)
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        if(node.item()>max || node.item() < min)
             return 0;
-        return BSTHelper(rootPtr->leftChildPtr, min, rootPtr->item+1)&&
-        BSTHelper(rootPtr->rightChildPtr, rootPtr->item-1, max);
+        // Widened, so that the slack of one past INT_MAX or INT_MIN
+        // cannot overflow.
+        return BSTHelper(node.left(), min, static_cast<long long>(node.item())+1)&&
+        BSTHelper(node.right(), static_cast<long long>(node.item())-1, max);
     }
 }
 
@@ -546,49 +1151,65 @@ int BinaryNodeTree<ItemType>::max(const ItemType& item1, const ItemType& item2){
 }
 template <typename ItemType>
 int BinaryNodeTree<ItemType>::getMax(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
     if (rootPtr==NULL) {
         std::string message("BinaryNodeTree::getRootData: called ");
         message += "on an empty tree.";
         
         throw PrecondViolatedExcep(message);
     }
+    if constexpr (std::is_arithmetic<ItemType>::value) {
+        if (isFlattened() ) {
+            return simdMax(flatItems.data(), flatItems.size() );
+        }
+    }
     int numCheck(rootPtr->item);
     
-    return getMaxHelper(rootPtr,numCheck);
+    return getMaxHelper(rootView(),numCheck);
 }
 template <typename ItemType>
 int BinaryNodeTree<ItemType>::getMin(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
     if (rootPtr==NULL) {
         std::string message("BinaryNodeTree::getRootData: called ");
         message += "on an empty tree.";
         
         throw PrecondViolatedExcep(message);
     }
+    if constexpr (std::is_arithmetic<ItemType>::value) {
+        if (isFlattened() ) {
+            return simdMin(flatItems.data(), flatItems.size() );
+        }
+    }
     int numCheck(rootPtr->item);
-   return getMinHelper(rootPtr,numCheck);
+   return getMinHelper(rootView(),numCheck);
 }
 
 template <typename ItemType>
-int BinaryNodeTree<ItemType>::getMaxHelper(BinaryNodePtr nodePtr, int maxNum){
-    if (nodePtr==NULL){
+int BinaryNodeTree<ItemType>::getMaxHelper(NodeView node, int maxNum){
+    if (!node){
         return maxNum;
     }
     else{
-        maxNum = max(nodePtr->item, maxNum);
-        maxNum = getMaxHelper(nodePtr->leftChildPtr, maxNum);
-        maxNum = getMaxHelper(nodePtr->rightChildPtr, maxNum);
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        maxNum = max(node.item(), maxNum);
+        maxNum = getMaxHelper(node.left(), maxNum);
+        maxNum = getMaxHelper(node.right(), maxNum);
         return maxNum;
     }
 }
 template <typename ItemType>
-int BinaryNodeTree<ItemType>::getMinHelper(BinaryNodePtr nodePtr, int minNum){
-    if (nodePtr==NULL){
+int BinaryNodeTree<ItemType>::getMinHelper(NodeView node, int minNum){
+    if (!node){
         return minNum;
     }
     else{
-        minNum = min(nodePtr->item, minNum);
-        minNum = getMinHelper(nodePtr->leftChildPtr, minNum);
-        minNum = getMinHelper(nodePtr->rightChildPtr, minNum);
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        minNum = min(node.item(), minNum);
+        minNum = getMinHelper(node.left(), minNum);
+        minNum = getMinHelper(node.right(), minNum);
         return minNum;
     }
 }
@@ -598,6 +1219,7 @@ int BinaryNodeTree<ItemType>::getMinHelper(BinaryNodePtr nodePtr, int minNum){
 //////////////////////////////////////////////////////////////
 template<typename ItemType>
 void BinaryNodeTree<ItemType>::printRootLeaf(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
     if (rootPtr == nullptr) {
         std::string message("Tree can't be empty");
         message += "on an empty tree.";
@@ -606,24 +1228,26 @@ void BinaryNodeTree<ItemType>::printRootLeaf(){
     
    long unsigned int height = getHeight();
     ItemType pathArray[height];
-    printRootHelper(rootPtr, pathArray, indexNum);
+    printRootHelper(rootView(), pathArray, indexNum);
 }
 
 template<typename ItemType>
-void BinaryNodeTree<ItemType>::printRootHelper(BinaryNodePtr nodePtr, ItemType arry[] , long unsigned int indexPrint) {
-    arry[indexNum] = nodePtr->item;
+void BinaryNodeTree<ItemType>::printRootHelper(NodeView node, ItemType arry[] , long unsigned int indexPrint) {
+    TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+    statsRecorder.nodeVisited();
+    arry[indexNum] = node.item();
     ++indexNum;
     
-    if(nodePtr->leftChildPtr != nullptr){// is left child
-        printRootHelper(nodePtr->leftChildPtr, arry, indexNum);
+    if(node.left()){// is left child
+        printRootHelper(node.left(), arry, indexNum);
         --indexNum;
     }
 
-    if(nodePtr->rightChildPtr!=nullptr ){// is right child
-        printRootHelper(nodePtr->rightChildPtr, arry,  indexNum);
+    if(node.right()){// is right child
+        printRootHelper(node.right(), arry,  indexNum);
         --indexNum;
     }
-    if(nodePtr->leftChildPtr == nullptr && nodePtr->rightChildPtr == nullptr){
+    if(node.isLeaf()){
         printArray(arry,indexNum);
     }
 }
@@ -634,7 +1258,7 @@ void BinaryNodeTree<ItemType>::printArray(ItemType pathArrayP[], long unsigned i
     for(long unsigned int i(0); i<length; ++i){
         std::cout<<pathArrayP[i]<<" ";
     }
-    std::cout<<std::endl;
+    std::cout<<'\n';
 }
 
 //////////////////////////////////////////////////////////////
@@ -642,6 +1266,7 @@ void BinaryNodeTree<ItemType>::printArray(ItemType pathArrayP[], long unsigned i
 //////////////////////////////////////////////////////////////
 template<typename ItemType>
 bool BinaryNodeTree<ItemType>::doesSomePathHaveSum(int value){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
     if (rootPtr==NULL) {
         std::string message("BinaryNodeTree::getRootData: called ");
         message += "on an empty tree.";
@@ -652,7 +1277,7 @@ bool BinaryNodeTree<ItemType>::doesSomePathHaveSum(int value){
     int start(0);
     long unsigned int height = getHeight();
     ItemType pathArray[height];
-    doesSomePathHaveSumHelper(rootPtr,pathArray,start, value,result);
+    doesSomePathHaveSumHelper(rootView(),pathArray,start, value,result);
     return result;
 }
 template<typename ItemType>
@@ -666,27 +1291,1066 @@ bool BinaryNodeTree<ItemType>::testPathArray(ItemType arr[], long unsigned int l
 }
 
 template<typename ItemType>
-void BinaryNodeTree<ItemType>::doesSomePathHaveSumHelper(BinaryNodePtr nodePtr,ItemType arry[],long unsigned int length, int valueAdded, bool& statusCheck){
+void BinaryNodeTree<ItemType>::doesSomePathHaveSumHelper(NodeView node,ItemType arry[],long unsigned int length, int valueAdded, bool& statusCheck){
     
-    if(nodePtr!= nullptr){
-        arry[length] = nodePtr->item;
+    TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+    statsRecorder.nodeVisited();
+    if(node){
+        arry[length] = node.item();
         ++length;
     }
     else {
         statusCheck = false;
     }
     
-    if ((nodePtr->leftChildPtr==nullptr)&&(nodePtr->rightChildPtr==nullptr)){
+    if (node.isLeaf()){
         if (testPathArray(arry, length, valueAdded)){
         statusCheck = true;
         }
     }
-        if(nodePtr->leftChildPtr!=nullptr){
-            doesSomePathHaveSumHelper(nodePtr->leftChildPtr, arry, length, valueAdded,statusCheck);
+        if(node.left()){
+            doesSomePathHaveSumHelper(node.left(), arry, length, valueAdded,statusCheck);
+        }
+        if(node.right()){
+            doesSomePathHaveSumHelper(node.right(), arry, length, valueAdded,statusCheck);
+        }
+}
+//////////////////////////////////////////////////////////////
+//Downward path sums using prefix-sum hashing.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+template<typename Accumulator>
+bool BinaryNodeTree<ItemType>::hasDownwardPathSum(const Accumulator& target) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    return downwardPathSumHelper(target, true) > 0;
+}
+template<typename ItemType>
+template<typename Accumulator>
+std::size_t BinaryNodeTree<ItemType>::countDownwardPathSums(const Accumulator& target) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    return downwardPathSumHelper(target, false);
+}
+
+/** A path from an ancestor a down to a node d sums to target exactly
+ *  when prefix(d) - target == prefix(parent of a), where prefix(x) is
+ *  the sum from the root to x. The multiset of prefix sums on the
+ *  current root path therefore answers each node in O(1).
+ *
+ *  @param target The wanted path sum.
+ *
+ *  @param stopAtFirst True to return as soon as one path is found.
+ *
+ *  @return The number of downward paths summing to target (at most 1
+ *          if stopAtFirst). */
+template<typename ItemType>
+template<typename Accumulator>
+std::size_t BinaryNodeTree<ItemType>::downwardPathSumHelper(const Accumulator& target,
+                                                            bool stopAtFirst) const{
+    struct Frame {
+        NodeView node;
+        Accumulator prefix;
+        bool entered;
+    };
+    ScratchBuffer<std::vector<Frame>> scratch;
+    auto& pending(scratch.get());
+    std::unordered_map<Accumulator, std::size_t> prefixCounts;
+    prefixCounts[Accumulator(0)] = 1;
+    std::size_t count(0);
+    
+    if (rootPtr){
+        pending.push_back({rootView(), Accumulator(0), false});
+    }
+    while (!pending.empty()){
+        auto& frame(pending.back());
+        if (frame.entered){
+            // Leaving the node: its prefix is no longer on the path.
+            auto found(prefixCounts.find(frame.prefix));
+            if (--found->second == 0){
+                prefixCounts.erase(found);
+            }
+            pending.pop_back();
+            continue;
+        }
+        
+        statsRecorder.nodeVisited();
+        statsRecorder.reachedDepth(static_cast<unsigned int>(pending.size()));
+        frame.entered = true;
+        frame.prefix = checkedAdd(frame.prefix, static_cast<Accumulator>(frame.node.item()));
+        Accumulator needed;
+        if (trySubtract(frame.prefix, target, needed)){
+            auto found(prefixCounts.find(needed));
+            if (found != prefixCounts.end()){
+                count += found->second;
+                if (stopAtFirst){
+                    return 1;
+                }
+            }
+        }
+        ++prefixCounts[frame.prefix];
+        
+        auto node(frame.node);
+        auto prefix(frame.prefix);
+        if (node.right()){
+            pending.push_back({node.right(), prefix, false});
+        }
+        if (node.left()){
+            pending.push_back({node.left(), prefix, false});
+        }
+    }
+    return count;
+}
+//////////////////////////////////////////////////////////////
+//Shape report.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+typename BinaryNodeTree<ItemType>::ShapeReport BinaryNodeTree<ItemType>::shapeReport() const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    ShapeReport report;
+    
+    // A node is pushed once to expand it and again, under its
+    // children, to finish it. Finished subtrees leave their heights
+    // on heights, left below right.
+    struct Frame {
+        NodeView node;
+        int depth;
+        bool expanded;
+    };
+    struct ShapeFrameTag {};
+    struct ShapeHeightTag {};
+    struct ShapeWidthTag {};
+    struct ShapeBalanceTag {};
+    ScratchBuffer<std::vector<Frame>, ShapeFrameTag> frameScratch;
+    ScratchBuffer<std::vector<int>, ShapeHeightTag> heightScratch;
+    ScratchBuffer<std::vector<std::size_t>, ShapeWidthTag> widthScratch;
+    ScratchBuffer<std::vector<std::size_t>, ShapeBalanceTag> balanceScratch;
+    auto& pending(frameScratch.get());
+    auto& heights(heightScratch.get());
+    auto& widths(widthScratch.get());
+    // Balance factor b is counted at index 2b for b >= 0 and
+    // 2(-b) - 1 for b < 0.
+    auto& balances(balanceScratch.get());
+    
+    if (rootPtr){
+        pending.push_back({rootView(), 0, false});
+    }
+    while (!pending.empty()){
+        auto frame(pending.back());
+        pending.pop_back();
+        
+        if (!frame.expanded){
+            statsRecorder.nodeVisited();
+            ++report.nodes;
+            report.internalPathLength += static_cast<unsigned long long>(frame.depth);
+            if (widths.size() <= static_cast<std::size_t>(frame.depth)){
+                widths.push_back(0);
+            }
+            ++widths[frame.depth];
+            
+            frame.expanded = true;
+            pending.push_back(frame);
+            if (frame.node.right()){
+                pending.push_back({frame.node.right(), frame.depth + 1, false});
+            }
+            if (frame.node.left()){
+                pending.push_back({frame.node.left(), frame.depth + 1, false});
+            }
+            continue;
+        }
+        
+        int rightHeight(0);
+        int leftHeight(0);
+        if (frame.node.right()){
+            rightHeight = heights.back();
+            heights.pop_back();
+        }
+        if (frame.node.left()){
+            leftHeight = heights.back();
+            heights.pop_back();
+        }
+        if (leftHeight == 0 && rightHeight == 0){
+            ++report.leaves;
+        }
+        report.diameter = std::max(report.diameter, leftHeight + rightHeight);
+        
+        const int balance(leftHeight - rightHeight);
+        const auto slot(balance >= 0 ? 2 * static_cast<std::size_t>(balance)
+                                     : 2 * static_cast<std::size_t>(-balance) - 1);
+        if (balances.size() <= slot){
+            balances.resize(slot + 1, 0);
+        }
+        ++balances[slot];
+        heights.push_back(1 + std::max(leftHeight, rightHeight));
+    }
+    
+    if (!heights.empty()){
+        report.height = heights.back();
+    }
+    for (std::size_t depth(0); depth < widths.size(); ++depth){
+        if (widths[depth] > report.maxWidth){
+            report.maxWidth = widths[depth];
+            report.widestDepth = static_cast<int>(depth);
+        }
+    }
+    for (std::size_t slot(0); slot < balances.size(); ++slot){
+        if (balances[slot] > 0){
+            const int balance(slot % 2 == 0 ? static_cast<int>(slot / 2)
+                                            : -static_cast<int>((slot + 1) / 2));
+            report.balanceFactors.emplace(balance, balances[slot]);
+        }
+    }
+    return report;
+}
+//////////////////////////////////////////////////////////////
+//Flattened item snapshot and vectorized reductions.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::touch() const{
+    ++version;
+}
+template<typename ItemType>
+template<typename Visitor>
+void BinaryNodeTree<ItemType>::forEachItem(NodeView node, Visitor& visit) const{
+    depthFirst<Enter>(node, [&visit](TraversalStage, NodeView current){
+        visit(current.item());
+    });
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::flatten(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    flatItems.clear();
+    auto append = [this](const ItemType& item){ flatItems.push_back(item); };
+    forEachItem(rootView(), append);
+    flatVersion = version;
+}
+template<typename ItemType>
+bool BinaryNodeTree<ItemType>::isFlattened() const{
+    return flatVersion == version;
+}
+template<typename ItemType>
+typename SimdSum<ItemType>::type BinaryNodeTree<ItemType>::sum() const{
+    if (isFlattened()){
+        return simdSum(flatItems.data(), flatItems.size());
+    }
+    typename SimdSum<ItemType>::type total(0);
+    auto add = [&total](const ItemType& item){ total += item; };
+    forEachItem(rootView(), add);
+    return total;
+}
+template<typename ItemType>
+template<typename Predicate>
+std::size_t BinaryNodeTree<ItemType>::countIf(Predicate pred) const{
+    if (isFlattened()){
+        return simdCountIf(flatItems.data(), flatItems.size(), pred);
+    }
+    std::size_t count(0);
+    auto test = [&count, &pred](const ItemType& item){ count += pred(item) ? 1 : 0; };
+    forEachItem(rootView(), test);
+    return count;
+}
+//////////////////////////////////////////////////////////////
+//Merge and split.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::collectNodes(const BinaryNodePtr& subTreePtr,
+                                            bool mirrored,
+                                            std::vector<BinaryNodePtr>& nodes){
+    if (subTreePtr){
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        auto node(ownedNode(subTreePtr, true));
+        bool nodeMirrored(mirrored != node->flipped);
+        // Detach the children first, so that an unshared child is
+        // held only here and can be reused too.
+        auto leftPtr(std::move(childSlot(*node, nodeMirrored, false)));
+        auto rightPtr(std::move(childSlot(*node, nodeMirrored, true)));
+        node->leftChildPtr.reset();
+        node->rightChildPtr.reset();
+        node->flipped = false;
+        
+        collectNodes(leftPtr, nodeMirrored, nodes);
+        nodes.push_back(std::move(node));
+        collectNodes(rightPtr, nodeMirrored, nodes);
+    }
+}
+template<typename ItemType>
+std::vector<typename BinaryNodeTree<ItemType>::BinaryNodePtr>
+BinaryNodeTree<ItemType>::releaseNodes(){
+    std::vector<BinaryNodePtr> nodes;
+    collectNodes(rootPtr, mirrored, nodes);
+    rootPtr.reset();
+    mirrored = false;
+    return nodes;
+}
+template<typename ItemType>
+std::shared_ptr<typename BinaryNodeTree<ItemType>::BinaryNode>
+BinaryNodeTree<ItemType>::buildBalanced(const std::vector<BinaryNodePtr>& nodes,
+                                        std::size_t low,
+                                        std::size_t high){
+    if (low >= high){
+        return nullptr;
+    }
+    auto middle(low + (high - low) / 2);
+    const auto& node(nodes[middle]);
+    node->leftChildPtr = buildBalanced(nodes, low, middle);
+    node->rightChildPtr = buildBalanced(nodes, middle + 1, high);
+    refreshHash(node);
+    return node;
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::merge(BinaryNodeTree& other){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    if (&other == this){
+        return;
+    }
+    auto nodes(releaseNodes());
+    auto otherNodes(other.releaseNodes());
+    nodes.insert(nodes.end(),
+                 std::make_move_iterator(otherNodes.begin()),
+                 std::make_move_iterator(otherNodes.end()));
+    setRootPtr(buildBalanced(nodes, 0, nodes.size()));
+    other.setRootPtr(nullptr);
+}
+template<typename ItemType>
+BinaryNodeTree<ItemType> BinaryNodeTree<ItemType>::splitAt(std::size_t k){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    auto nodes(releaseNodes());
+    k = std::min(k, nodes.size());
+    BinaryNodeTree rest;
+    rest.setRootPtr(buildBalanced(nodes, k, nodes.size()));
+    setRootPtr(buildBalanced(nodes, 0, k));
+    return rest;
+}
+template<typename ItemType>
+template<typename Predicate>
+BinaryNodeTree<ItemType> BinaryNodeTree<ItemType>::partition(Predicate pred){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    auto nodes(releaseNodes());
+    std::vector<BinaryNodePtr> matching;
+    std::vector<BinaryNodePtr> remaining;
+    for (auto& node : nodes){
+        (pred(node->item) ? matching : remaining).push_back(std::move(node));
+    }
+    BinaryNodeTree moved;
+    moved.setRootPtr(buildBalanced(matching, 0, matching.size()));
+    setRootPtr(buildBalanced(remaining, 0, remaining.size()));
+    return moved;
+}
+//////////////////////////////////////////////////////////////
+//Reconstruction from traversals and export.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+template<typename PreorderIterator, typename InorderIterator>
+void BinaryNodeTree<ItemType>::buildFromTraversals(PreorderIterator preorderFirst,
+                                                   PreorderIterator preorderLast,
+                                                   InorderIterator inorderFirst,
+                                                   InorderIterator inorderLast){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    auto mismatch = [](){
+        std::string message("BinaryNodeTree::buildFromTraversals: ");
+        message += "the sequences do not describe the same tree.";
+        throw PrecondViolatedExcep(message);
+    };
+    
+    // Each preorder item is the left child of the previous one until
+    // the inorder sequence reaches that item. Then the nodes whose
+    // left subtrees are complete are popped in inorder, and the new
+    // item is the right child of the last one popped. pending is the
+    // path of nodes whose inorder turn has not come yet.
+    BinaryNodePtr newRootPtr;
+    std::vector<BinaryNode*> pending;
+    std::vector<BinaryNode*> built;
+    for (; preorderFirst != preorderLast; ++preorderFirst){
+        auto nodePtr(std::make_shared<BinaryNode>(*preorderFirst));
+        statsRecorder.allocated();
+        statsRecorder.itemCopied();
+        BinaryNode* parent(nullptr);
+        while (!pending.empty() && inorderFirst != inorderLast &&
+               pending.back()->item == *inorderFirst){
+            parent = pending.back();
+            pending.pop_back();
+            ++inorderFirst;
+        }
+        if (parent){
+            parent->rightChildPtr = nodePtr;
+        }
+        else if (!pending.empty()){
+            pending.back()->leftChildPtr = nodePtr;
+        }
+        else if (!newRootPtr){
+            newRootPtr = nodePtr;
+        }
+        else {
+            mismatch();
+        }
+        pending.push_back(nodePtr.get());
+        built.push_back(nodePtr.get());
+    }
+    // The rest of the inorder sequence must pop the remaining path.
+    while (!pending.empty() && inorderFirst != inorderLast &&
+           pending.back()->item == *inorderFirst){
+        pending.pop_back();
+        ++inorderFirst;
+    }
+    if (!pending.empty() || inorderFirst != inorderLast){
+        mismatch();
+    }
+    
+    // Descendants follow their ancestors in preorder, so hashing
+    // backwards sees children first.
+    for (auto node(built.rbegin()); node != built.rend(); ++node){
+        refreshHash(*node);
+    }
+    setRootPtr(newRootPtr);
+}
+template<typename ItemType>
+template<typename InputIterator>
+void BinaryNodeTree<ItemType>::buildFromLevelorder(InputIterator first, InputIterator last){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    
+    // frontier holds the nodes whose children come next, in order;
+    // each entry is consumed by its left and then its right slot.
+    BinaryNodePtr newRootPtr;
+    std::vector<BinaryNode*> built;
+    RingQueue<BinaryNode*> frontier;
+    bool rightSlot(false);
+    for (; first != last; ++first){
+        const std::optional<ItemType>& entry(*first);
+        if (!newRootPtr){
+            if (!entry){
+                // An empty tree: nothing else may follow.
+                for (++first; first != last; ++first){
+                    if (*first){
+                        std::string message("BinaryNodeTree::buildFromLevelorder: ");
+                        message += "items follow an empty root.";
+                        throw PrecondViolatedExcep(message);
+                    }
+                }
+                break;
+            }
+            newRootPtr = std::make_shared<BinaryNode>(*entry);
+            statsRecorder.allocated();
+            statsRecorder.itemCopied();
+            built.push_back(newRootPtr.get());
+            frontier.enqueue(newRootPtr.get());
+            continue;
+        }
+        if (frontier.isEmpty()){
+            if (*first){
+                std::string message("BinaryNodeTree::buildFromLevelorder: ");
+                message += "an item has no parent.";
+                throw PrecondViolatedExcep(message);
+            }
+            continue;
+        }
+        
+        auto parent(frontier.peekFront());
+        if (entry){
+            auto nodePtr(std::make_shared<BinaryNode>(*entry));
+            statsRecorder.allocated();
+            statsRecorder.itemCopied();
+            (rightSlot ? parent->rightChildPtr : parent->leftChildPtr) = nodePtr;
+            built.push_back(nodePtr.get());
+            frontier.enqueue(nodePtr.get());
         }
-        if(nodePtr->rightChildPtr!=nullptr){
-            doesSomePathHaveSumHelper(nodePtr->rightChildPtr, arry, length, valueAdded,statusCheck);
+        if (rightSlot){
+            frontier.dequeue();
+        }
+        rightSlot = !rightSlot;
+    }
+    
+    // Reverse level order also sees children before parents.
+    for (auto node(built.rbegin()); node != built.rend(); ++node){
+        refreshHash(*node);
+    }
+    setRootPtr(newRootPtr);
+}
+template<typename ItemType>
+template<typename InputIterator>
+void BinaryNodeTree<ItemType>::buildFromAdds(InputIterator first, InputIterator last){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Add);
+    
+    // Node i holds the i-th item. Each entry mirrors what balancedAdd
+    // reads: the heights of both subtrees, and the children to descend
+    // into. Children always come after their parents.
+    struct Slot {
+        std::uint32_t left = LcaIndex::npos;
+        std::uint32_t right = LcaIndex::npos;
+        std::uint32_t parent = LcaIndex::npos;
+        std::uint32_t leftHeight = 0;
+        std::uint32_t rightHeight = 0;
+    };
+    std::vector<Slot> slots;
+    std::vector<BinaryNodePtr> built;
+    for (; first != last; ++first){
+        if (built.size() >= LcaIndex::npos){
+            std::string message("BinaryNodeTree::buildFromAdds: ");
+            message += "too many items.";
+            throw PrecondViolatedExcep(message);
         }
+        auto index(static_cast<std::uint32_t>(built.size()));
+        built.push_back(std::make_shared<BinaryNode>(*first));
+        statsRecorder.allocated();
+        statsRecorder.itemCopied();
+        slots.emplace_back();
+        if (index == 0){
+            continue;
+        }
+        
+        // Descend as balancedAdd does: right if the left subtree is
+        // taller, else left.
+        std::uint32_t parent(0);
+        bool right;
+        for (;;){
+            right = slots[parent].leftHeight > slots[parent].rightHeight;
+            auto child(right ? slots[parent].right : slots[parent].left);
+            if (child == LcaIndex::npos){
+                break;
+            }
+            parent = child;
+        }
+        (right ? slots[parent].right : slots[parent].left) = index;
+        slots[index].parent = parent;
+        
+        // Raise the heights on the way back up until one is unchanged.
+        for (auto node(index); node != 0; node = slots[node].parent){
+            const auto& slot(slots[node]);
+            auto height(1 + std::max(slot.leftHeight, slot.rightHeight));
+            auto& above(slots[slot.parent]);
+            auto& stored(above.left == node ? above.leftHeight : above.rightHeight);
+            if (stored == height){
+                break;
+            }
+            stored = height;
+        }
+    }
+    
+    // Link and hash children before parents.
+    for (auto index(built.size()); index-- > 0; ){
+        const auto& slot(slots[index]);
+        if (slot.left != LcaIndex::npos){
+            built[index]->leftChildPtr = built[slot.left];
+        }
+        if (slot.right != LcaIndex::npos){
+            built[index]->rightChildPtr = built[slot.right];
+        }
+        refreshHash(built[index]);
+    }
+    setRootPtr(built.empty() ? nullptr : built.front());
+}
+template<typename ItemType>
+template<typename OutputIterator>
+OutputIterator BinaryNodeTree<ItemType>::exportPreorder(OutputIterator out) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    depthFirst<Enter>(rootView(), [&out](TraversalStage, NodeView node){
+        *out = node.item();
+        ++out;
+    });
+    return out;
+}
+template<typename ItemType>
+template<typename OutputIterator>
+OutputIterator BinaryNodeTree<ItemType>::exportInorder(OutputIterator out) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    depthFirst<Between>(rootView(), [&out](TraversalStage, NodeView node){
+        *out = node.item();
+        ++out;
+    });
+    return out;
+}
+template<typename ItemType>
+template<typename OutputIterator>
+OutputIterator BinaryNodeTree<ItemType>::exportLevelorder(OutputIterator out) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    struct ExportQueueTag {};
+    ScratchBuffer<RingQueue<NodeView>, ExportQueueTag> scratch;
+    auto& queue(scratch.get());
+    
+    // Empty slots are held back until an item follows them, so that
+    // trailing ones are never written.
+    std::size_t heldEmpties(0);
+    auto emit = [&out, &heldEmpties](const NodeView& node){
+        if (!node){
+            ++heldEmpties;
+            return;
+        }
+        for (; heldEmpties > 0; --heldEmpties){
+            *out = std::optional<ItemType>();
+            ++out;
+        }
+        *out = std::optional<ItemType>(node.item());
+        ++out;
+    };
+    
+    if (rootPtr){
+        emit(rootView());
+        queue.enqueue(rootView());
+    }
+    while (!queue.isEmpty()){
+        auto node(queue.peekFront());
+        queue.dequeue();
+        statsRecorder.nodeVisited();
+        for (auto child : {node.left(), node.right()}){
+            emit(child);
+            if (child){
+                queue.enqueue(child);
+            }
+        }
+    }
+    return out;
+}
+//////////////////////////////////////////////////////////////
+//Non-throwing variants.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+std::optional<ItemType> BinaryNodeTree<ItemType>::tryGetEntry(const ItemType& anEntry) const{
+    return tryGetEntryByKey(Lookup::keyOf(anEntry));
+}
+template<typename ItemType>
+template<typename KeyType, typename>
+std::optional<ItemType> BinaryNodeTree<ItemType>::tryGetEntry(const KeyType& key) const{
+    return tryGetEntryByKey(key);
+}
+template<typename ItemType>
+template<typename KeyType>
+std::optional<ItemType> BinaryNodeTree<ItemType>::tryGetEntryByKey(const KeyType& key) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::GetEntry);
+    if (!mayContain(key)){
+        return std::nullopt;
+    }
+    auto nodeView(findNode(rootView(), key));
+    if (!nodeView){
+        recordLookup(nullptr);
+        return std::nullopt;
+    }
+    statsRecorder.itemCopied();
+    // Copied first: a promotion may move another item into the node.
+    std::optional<ItemType> entry(nodeView.item());
+    recordLookup(&*entry);
+    return entry;
+}
+template<typename ItemType>
+std::optional<ItemType> BinaryNodeTree<ItemType>::tryGetRootData() const{
+    if (isEmpty()){
+        return std::nullopt;
+    }
+    return getRootData();
+}
+template<typename ItemType>
+std::optional<int> BinaryNodeTree<ItemType>::tryGetMax(){
+    if (isEmpty()){
+        return std::nullopt;
+    }
+    return getMax();
+}
+template<typename ItemType>
+std::optional<int> BinaryNodeTree<ItemType>::tryGetMin(){
+    if (isEmpty()){
+        return std::nullopt;
+    }
+    return getMin();
+}
+template<typename ItemType>
+bool BinaryNodeTree<ItemType>::tryPrintRootLeaf(){
+    if (isEmpty()){
+        return false;
+    }
+    printRootLeaf();
+    return true;
+}
+template<typename ItemType>
+std::optional<bool> BinaryNodeTree<ItemType>::tryDoesSomePathHaveSum(int value){
+    if (isEmpty()){
+        return std::nullopt;
+    }
+    return doesSomePathHaveSum(value);
+}
+//////////////////////////////////////////////////////////////
+//Membership filter.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+CountingBloomFilter* BinaryNodeTree<ItemType>::writableFilter(){
+    if (membershipFilter && membershipFilter.use_count() > 1){
+        membershipFilter = std::make_shared<CountingBloomFilter>(*membershipFilter);
+        statsRecorder.allocated();
+    }
+    return membershipFilter.get();
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::rebuildMembershipFilter(){
+    if (auto filter = writableFilter()){
+        filter->clear();
+        auto insert = [filter](const ItemType& item){ filter->insert(keyHash(item)); };
+        forEachItem(rootView(), insert);
+    }
+}
+template<typename ItemType>
+template<typename KeyType>
+bool BinaryNodeTree<ItemType>::mayContain(const KeyType& key) const{
+    if constexpr (CanHashKey<ItemType, KeyType>::value){
+        return !membershipFilter || membershipFilter->mayContain(Lookup::hash(key));
+    }
+    else {
+        static_cast<void>(key);
+        return true;
+    }
+}
+template<typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::keyHash(const ItemType& anItem){
+    // Only the filter, the ancestor index and the adaptive layout use
+    // key hashes, and each checks keysHashed first.
+    if constexpr (keysHashed){
+        return Lookup::hash(Lookup::keyOf(anItem));
+    }
+    else {
+        static_cast<void>(anItem);
+        return 0;
+    }
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::enableMembershipFilter(std::size_t expectedItems,
+                                                      double falsePositiveRate,
+                                                      std::size_t maxBytes){
+    static_assert(keysHashed,
+                  "The membership filter stores key hashes; give LookupTraits a hash.");
+    membershipFilter = std::make_shared<CountingBloomFilter>(expectedItems,
+                                                             falsePositiveRate,
+                                                             maxBytes);
+    statsRecorder.allocated();
+    rebuildMembershipFilter();
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::disableMembershipFilter(){
+    membershipFilter.reset();
+}
+template<typename ItemType>
+std::size_t BinaryNodeTree<ItemType>::membershipFilterBytes() const{
+    return membershipFilter ? membershipFilter->sizeInBytes() : 0;
+}
+//////////////////////////////////////////////////////////////
+//Adaptive layout.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::recordLookup(const ItemType* found) const{
+    if constexpr (keysHashed){
+        if (promotionPeriod == 0){
+            return;
+        }
+        if (found){
+            ++accessCounts[keyHash(*found)];
+        }
+        if (--lookupsUntilPromotion == 0){
+            lookupsUntilPromotion = promotionPeriod;
+            try {
+                promoteHotItemsHelper();
+            }
+            catch (const std::bad_alloc&) {
+                // Cloning shared nodes ran out of memory. The layout is
+                // only a speedup, so the lookup still succeeds, and the
+                // counts are kept for the next period.
+            }
+        }
+    }
+    else {
+        static_cast<void>(found);
+    }
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::promoteHotItemsHelper() const{
+    // Items are about to move, so nodes a copy still shares are
+    // cloned first, as in the mutating traversals.
+    rootPtr = unshareTree(rootPtr, true);
+    
+    // The nodes in preorder, which is the order findNode tries them.
+    std::vector<NodeView> order;
+    std::vector<NodeView> pending;
+    if (rootPtr){
+        pending.push_back(rootView());
+    }
+    while (!pending.empty()){
+        auto node(pending.back());
+        pending.pop_back();
+        statsRecorder.nodeVisited();
+        order.push_back(node);
+        for (bool right : {true, false}){
+            if (childOf(*node.get(), node.isMirrored(), right)){
+                pending.push_back(node.child(right));
+            }
+        }
+    }
+    
+    // The first node of each counted key, as (hits, position). A
+    // count is zeroed once seen so that duplicates are skipped. Keys
+    // whose hashes collide share a count, which only costs accuracy.
+    std::vector<std::pair<std::uint32_t, std::size_t>> hot;
+    for (std::size_t position(0); position < order.size(); ++position){
+        auto found(accessCounts.find(keyHash(order[position].item())));
+        if (found != accessCounts.end() && found->second > 0){
+            hot.emplace_back(found->second, position);
+            found->second = 0;
+        }
+    }
+    std::stable_sort(hot.begin(), hot.end(),
+                     [](const std::pair<std::uint32_t, std::size_t>& lhs,
+                        const std::pair<std::uint32_t, std::size_t>& rhs){
+                         return lhs.first > rhs.first;
+                     });
+    
+    // Swaps the i-th hottest item into position i. hotAt tracks which
+    // hot item each position holds, so displaced ones are found.
+    //
+    // Moving items inside a const lookup is safe here because the
+    // set of items is unchanged, so contains, getEntry and the
+    // membership filter give the same answers. No reference into a
+    // node escapes a public lookup, since entries are returned by
+    // value. Everything that does depend on the order (the flat
+    // snapshot, the ancestor index and live generators) checks the
+    // version, which touch() bumps below.
+    const std::size_t none(~std::size_t(0));
+    std::vector<std::size_t> hotAt(order.size(), none);
+    for (std::size_t rank(0); rank < hot.size(); ++rank){
+        hotAt[hot[rank].second] = rank;
+    }
+    for (std::size_t rank(0); rank < hot.size(); ++rank){
+        const auto from(hot[rank].second);
+        if (from == rank){
+            continue;
+        }
+        std::swap(order[rank].item(), order[from].item());
+        statsRecorder.itemCopied();
+        if (hotAt[rank] != none){
+            hot[hotAt[rank]].second = from;
+        }
+        hotAt[from] = hotAt[rank];
+        hotAt[rank] = rank;
+        // The item now sits at rank; the aging below reads it there.
+        hot[rank].second = rank;
+    }
+    
+    // Descendants follow their ancestors in preorder, so refreshing
+    // backwards recomputes children before parents.
+    for (auto node(order.rbegin()); node != order.rend(); ++node){
+        refreshHash(node->get());
+    }
+    
+    // Age the counts, dropping keys that went cold or left the tree.
+    accessCounts.clear();
+    for (const auto& entry : hot){
+        if (entry.first / 2 > 0){
+            accessCounts.emplace(keyHash(order[entry.second].item()), entry.first / 2);
+        }
+    }
+    touch();
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::enableAdaptiveLayout(std::size_t period){
+    static_assert(keysHashed,
+                  "Adaptive layout counts hits by key hash; give LookupTraits a hash.");
+    if (period == 0){
+        std::string message("BinaryNodeTree::enableAdaptiveLayout: ");
+        message += "period must be positive.";
+        throw PrecondViolatedExcep(message);
+    }
+    promotionPeriod = period;
+    lookupsUntilPromotion = period;
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::disableAdaptiveLayout(){
+    promotionPeriod = 0;
+    accessCounts.clear();
+}
+template<typename ItemType>
+bool BinaryNodeTree<ItemType>::isAdaptiveLayoutEnabled() const{
+    return promotionPeriod != 0;
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::promoteHotItems(){
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    promoteHotItemsHelper();
+}
+//////////////////////////////////////////////////////////////
+//Lowest common ancestor and distance queries.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::refreshAncestorIndex() const{
+    // Double-checked: only the first caller after a mutation builds;
+    // the release store below makes the finished index visible to
+    // callers that pass the first check.
+    if (ancestorVersion.load(std::memory_order_acquire) == version){
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ancestorMutex);
+    if (ancestorVersion.load(std::memory_order_relaxed) == version){
+        return;
+    }
+    ancestorIndex.clear();
+    ancestorItems.clear();
+    ancestorPositions.clear();
+    
+    ScratchBuffer<std::vector<std::pair<NodeView, std::uint32_t>>> scratch;
+    auto& pending(scratch.get());
+    if (rootPtr){
+        pending.emplace_back(rootView(), LcaIndex::npos);
+    }
+    while (!pending.empty()){
+        auto entry(pending.back());
+        pending.pop_back();
+        statsRecorder.nodeVisited();
+        
+        auto position(ancestorIndex.append(entry.second));
+        ancestorItems.push_back(&entry.first.item());
+        if constexpr (keysHashed){
+            ancestorPositions.emplace(keyHash(entry.first.item()), position);
+        }
+        if (entry.first.right()){
+            pending.emplace_back(entry.first.right(), position);
+        }
+        if (entry.first.left()){
+            pending.emplace_back(entry.first.left(), position);
+        }
+    }
+    ancestorIndex.build();
+    ancestorVersion.store(version, std::memory_order_release);
+}
+template<typename ItemType>
+std::uint32_t BinaryNodeTree<ItemType>::ancestorPosition(const ItemType& anEntry,
+                                                         const char* caller) const{
+    // The smallest matching position is the first node in preorder;
+    // other positions under the same hash are duplicates or collisions.
+    const auto& key(Lookup::keyOf(anEntry));
+    auto matches = [this, &key](std::uint32_t position){
+        return Lookup::equal(Lookup::keyOf(*ancestorItems[position]), key);
+    };
+    auto first(LcaIndex::npos);
+    if constexpr (keysHashed){
+        auto range(ancestorPositions.equal_range(keyHash(anEntry)));
+        for (auto entry(range.first); entry != range.second; ++entry){
+            if (entry->second < first && matches(entry->second)){
+                first = entry->second;
+            }
+        }
+    }
+    else {
+        for (std::uint32_t position(0); position < ancestorItems.size(); ++position){
+            if (matches(position)){
+                first = position;
+                break;
+            }
+        }
+    }
+    if (first == LcaIndex::npos){
+        std::string message("BinaryNodeTree::");
+        message += caller;
+        message += ": Entry not found in this tree.";
+        throw NotFoundException(message);
+    }
+    return first;
+}
+template<typename ItemType>
+ItemType BinaryNodeTree<ItemType>::lowestCommonAncestor(const ItemType& first,
+                                                        const ItemType& second) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    refreshAncestorIndex();
+    auto ancestor(ancestorIndex.lowestCommonAncestor(ancestorPosition(first, "lowestCommonAncestor"),
+                                                     ancestorPosition(second, "lowestCommonAncestor")));
+    statsRecorder.itemCopied();
+    return *ancestorItems[ancestor];
+}
+template<typename ItemType>
+int BinaryNodeTree<ItemType>::distance(const ItemType& first, const ItemType& second) const{
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Query);
+    refreshAncestorIndex();
+    return static_cast<int>(ancestorIndex.distance(ancestorPosition(first, "distance"),
+                                                   ancestorPosition(second, "distance")));
+}
+#ifdef TREE_GENERATORS
+//////////////////////////////////////////////////////////////
+//Lazy traversal generators.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::checkUnchanged(unsigned long long startVersion,
+                                              const char* caller) const{
+    if (version != startVersion){
+        std::string message("BinaryNodeTree::");
+        message += caller;
+        message += ": tree modified during traversal.";
+        throw PrecondViolatedExcep(message);
+    }
+}
+template<typename ItemType>
+Generator<ItemType> BinaryNodeTree<ItemType>::inorder() const{
+    const auto startVersion(version);
+    std::vector<NodeView> pending;
+    auto node(rootView());
+    while (node || !pending.empty()){
+        while (node){
+            pending.push_back(node);
+            node = node.left();
+        }
+        node = pending.back();
+        pending.pop_back();
+        co_yield node.item();
+        checkUnchanged(startVersion, "inorder");
+        node = node.right();
+    }
+}
+template<typename ItemType>
+Generator<ItemType> BinaryNodeTree<ItemType>::preorder() const{
+    const auto startVersion(version);
+    std::vector<NodeView> pending;
+    if (rootPtr){
+        pending.push_back(rootView());
+    }
+    while (!pending.empty()){
+        auto node(pending.back());
+        pending.pop_back();
+        co_yield node.item();
+        checkUnchanged(startVersion, "preorder");
+        if (node.right()){
+            pending.push_back(node.right());
+        }
+        if (node.left()){
+            pending.push_back(node.left());
+        }
+    }
+}
+template<typename ItemType>
+Generator<std::vector<ItemType>> BinaryNodeTree<ItemType>::rootToLeafPaths() const{
+    const auto startVersion(version);
+    std::vector<std::pair<NodeView, std::size_t>> pending;
+    std::vector<ItemType> path;
+    if (rootPtr){
+        pending.emplace_back(rootView(), 0);
+    }
+    while (!pending.empty()){
+        auto entry(pending.back());
+        pending.pop_back();
+        // Drop the part of the path below this node's parent.
+        path.resize(entry.second);
+        path.push_back(entry.first.item());
+        if (entry.first.isLeaf()){
+            co_yield path;
+            checkUnchanged(startVersion, "rootToLeafPaths");
+            continue;
+        }
+        if (entry.first.right()){
+            pending.emplace_back(entry.first.right(), path.size());
+        }
+        if (entry.first.left()){
+            pending.emplace_back(entry.first.left(), path.size());
+        }
+    }
+}
+#endif
+//////////////////////////////////////////////////////////////
+//Instrumentation counters.
+//////////////////////////////////////////////////////////////
+template<typename ItemType>
+TreeStats BinaryNodeTree<ItemType>::stats() const{
+    return statsRecorder.snapshot();
+}
+template<typename ItemType>
+void BinaryNodeTree<ItemType>::resetStats(){
+    statsRecorder.reset();
 }
 //////////////////////////////////////////////////////////////
 //Good BYE CS1521 Projects.
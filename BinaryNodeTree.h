@@ -18,94 +18,406 @@
 
 #ifndef BINARY_NODE_TREE_
 #define BINARY_NODE_TREE_
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "BinaryTreeInterface.h"
+#include "CountingBloomFilter.h"
+#include "Generator.h"
+#include "LcaIndex.h"
+#include "LookupTraits.h"
+#include "PathSumTraits.h"
+#include "RingQueue.h"
+#include "ScratchBuffer.h"
+#include "SimdKernels.h"
+#include "TreeStats.h"
+
+template <typename ItemType>
+class SuccinctBinaryTree;
+template <typename ItemType>
+class DurableBinaryTree;
+template <typename ItemType>
+class PagedBinaryTree;
 
 /** @class BinaryNodeTree BinaryNodeTree.h "BinaryNodeTree.h"
  *
  *  Specification of a link-based ADT binary tree. */
 template <typename ItemType>
 class BinaryNodeTree : public BinaryTreeInterface<ItemType> {
+    // Encodes the tree from its nodes.
+    friend class SuccinctBinaryTree<ItemType>;
+    // Writes checkpoints from the nodes and relinks them on recovery.
+    friend class DurableBinaryTree<ItemType>;
+    // Lays out copies of the nodes in disk pages.
+    friend class PagedBinaryTree<ItemType>;
+    
 protected:
     class BinaryNode;
     using BinaryNodePtr = std::shared_ptr<BinaryNode>;
+    // Key, equality and hash of lookups (see LookupTraits.h).
+    using Lookup = LookupTraits<ItemType>;
+    template <typename KeyType>
+    using EnableIfLookupKey = typename std::enable_if<IsLookupKey<ItemType, KeyType>::value>::type;
+    
+    /** Non-owning handle to a node, seen through any pending flips.
+     *  Read paths walk the tree with views instead of copying
+     *  BinaryNodePtrs, so concurrent readers never write to the shared
+     *  reference counts. A view is only valid while the tree is not
+     *  mutated. */
+    class NodeView {
+    public:
+        NodeView() = default;
+        
+        // mirrored is the parity of the flips pending above nodePtr;
+        // the node's own flag is folded in here.
+        NodeView(BinaryNode* nodePtr, bool mirrored)
+        : nodePtr(nodePtr),
+          nodeMirrored(nodePtr ? mirrored != nodePtr->flipped : mirrored) {
+        }
+        
+        explicit operator bool() const { return nodePtr != nullptr; }
+        bool operator==(const NodeView& other) const {
+            return nodePtr == other.nodePtr && nodeMirrored == other.nodeMirrored;
+        }
+        
+        ItemType& item() const { return nodePtr->item; }
+        BinaryNode* get() const { return nodePtr; }
+        bool isMirrored() const { return nodeMirrored; }
+        
+        NodeView left() const { return child(false); }
+        NodeView right() const { return child(true); }
+        NodeView child(bool right) const {
+            return NodeView(childOf(*nodePtr, nodeMirrored, right).get(),
+                            nodeMirrored);
+        }
+        
+        bool isLeaf() const {
+            return !nodePtr->leftChildPtr && !nodePtr->rightChildPtr;
+        }
+        
+        // Merkle hash of the subtree as this view sees it.
+        std::size_t hash() const {
+            return nodePtr->subtreeHash[nodeMirrored != nodePtr->flipped];
+        }
+        
+    private:
+        BinaryNode* nodePtr = nullptr;
+        bool nodeMirrored = false;
+    };
     
 private:
-    BinaryNodePtr rootPtr;
+    // Mutable only so that an adaptive promotion, which runs inside
+    // const lookups, can clone nodes shared with a copy before it
+    // moves items (see promoteHotItemsHelper).
+    mutable BinaryNodePtr rootPtr;
     long unsigned int indexNum = 0;
     
+    // True if the whole tree is flipped. flip() only toggles this flag;
+    // the nodes are read mirrored instead of being rewritten.
+    bool mirrored = false;
+    
+    // Bumped by every mutator, and by adaptive promotions (which run
+    // inside const lookups); caches remember the version they were
+    // built for.
+    mutable unsigned long long version = 0;
+    
+    // Contiguous copy of the items made by flatten(), in preorder. It
+    // is current while flatVersion == version.
+    std::vector<ItemType> flatItems;
+    unsigned long long flatVersion = ~0ULL;
+    
+    // Ancestor queries: the nodes in preorder, and the preorder
+    // positions filed under the hash of their keys (see keyHash), so
+    // that no std::hash<ItemType> is needed. Without a key hash the
+    // positions are found by scanning ancestorItems. Rebuilt on the
+    // first query after a mutation, under ancestorMutex, so that
+    // concurrent const callers do not race; ancestorVersion is
+    // published last, and queries that see it current read the index
+    // without locking.
+    mutable LcaIndex ancestorIndex;
+    mutable std::vector<const ItemType*> ancestorItems;
+    mutable std::unordered_multimap<std::size_t, std::uint32_t> ancestorPositions;
+    mutable std::atomic<unsigned long long> ancestorVersion{~0ULL};
+    mutable std::mutex ancestorMutex;
+    
+    // Optional filter of the item hashes, so that most lookups of
+    // absent items return without walking the tree. Shared between
+    // copies like the nodes, and cloned before a shared one changes.
+    std::shared_ptr<CountingBloomFilter> membershipFilter;
+    
+    // Adaptive layout: hits since the last promotion, filed under the
+    // keyHash of the item found, and the lookups left until the next
+    // promotion. Disabled while promotionPeriod is 0.
+    mutable std::unordered_map<std::size_t, std::uint32_t> accessCounts;
+    mutable std::size_t lookupsUntilPromotion = 0;
+    std::size_t promotionPeriod = 0;
+    
+    // Hot-path counters; compiled away unless BINARY_TREE_STATS is
+    // defined (see TreeStats.h).
+    mutable TreeStatsRecorder statsRecorder;
+    
 protected:
     //------------------------------------------------------------
     // Protected Utility Methods Section:
     // Recursive helper methods for the public methods.
     //------------------------------------------------------------
     
-    int getHeightHelper(BinaryNodePtr subTreePtr) const;
+    // Read-only helpers take NodeViews; see NodeView.
+    int getHeightHelper(NodeView subTree) const;
     
-    int getNumberOfNodesHelper(BinaryNodePtr subTreePtr) const;
+    int getNumberOfNodesHelper(NodeView subTree) const;
     
     // Recursively adds a new node to the tree in a left/right fashion to
     // keep the tree balanced.
-    BinaryNodePtr balancedAdd(BinaryNodePtr subTreePtr,
-                              BinaryNodePtr newNodePtr);
+    // The exclusive flag of the mutating helpers is true when no other
+    // tree shares the path down to subTreePtr (see ownedNode).
+    // The mirrored flag of every helper is true when an odd number of
+    // flips is pending above subTreePtr (see childOf).
+    BinaryNodePtr balancedAdd(const BinaryNodePtr& subTreePtr,
+                              const BinaryNodePtr& newNodePtr,
+                              bool exclusive,
+                              bool mirrored);
     
-    // Removes the target value from the tree by calling moveValuesUpTree
-    // to overwrite value with value from child.
-    BinaryNodePtr removeValue(BinaryNodePtr subTreePtr,
+    // Removes the first item whose key matches target's by calling
+    // moveValuesUpTree to overwrite value with value from child.
+    BinaryNodePtr removeValue(const BinaryNodePtr& subTreePtr,
                               const ItemType& target,
-                              bool& success);
+                              bool& success,
+                              bool exclusive,
+                              bool mirrored);
     
     // Copies values up the tree to overwrite value in current node until
     // a leaf is reached; the leaf is then removed, since its value is
     // stored in the parent.
-    BinaryNodePtr moveValuesUpTree(BinaryNodePtr subTreePtr);
+    BinaryNodePtr moveValuesUpTree(const BinaryNodePtr& subTreePtr,
+                                   bool exclusive,
+                                   bool mirrored);
+    
+    // Copy-on-write support: returns a node that may be modified
+    // without affecting other trees, cloning it if it is shared.
+    BinaryNodePtr ownedNode(const BinaryNodePtr& nodePtr,
+                            bool exclusive) const;
+    
+    // Clones every shared node of the subtree.
+    BinaryNodePtr unshareTree(const BinaryNodePtr& subTreePtr,
+                              bool exclusive) const;
+    
+    // Recursively searches for an item whose key equals key in the
+    // tree by using a preorder traversal.
+    template <typename KeyType>
+    NodeView findNode(NodeView subTree,
+                      const KeyType& key) const;
     
-    // Recursively searches for target value in the tree by using a
-    // preorder traversal.
-    BinaryNodePtr findNode(BinaryNodePtr treePtr,
-                           const ItemType& target) const;
+    // contains and tryGetEntry by key, shared by the item and the
+    // heterogeneous overloads.
+    template <typename KeyType>
+    bool containsKey(const KeyType& key) const;
+    template <typename KeyType>
+    std::optional<ItemType> tryGetEntryByKey(const KeyType& key) const;
     
     // Copies the tree rooted at treePtr and returns a pointer to
-    // the copy.
+    // the copy, with any pending flips applied (so the copy reads the
+    // same under either parity).
     BinaryNodePtr copyTree(const BinaryNodePtr& treePtr) const;
     
-    // Recursive traversal helper methods:
+    // Iterative depth-first walk shared by the traversal helpers.
+    // For each stage in Stages, visit(stage, node) is called: Enter
+    // before the node's children, Between after its left subtree and
+    // Leave after both. The explicit stack is a thread-local
+    // ScratchBuffer reused across calls, and every child is
+    // prefetched as it is pushed, so loading a right child overlaps
+    // the walk of its left sibling.
+    enum TraversalStage : unsigned {
+        Enter = 1,
+        Between = 2,
+        Leave = 4
+    };
+    template <unsigned Stages, typename Visitor>
+    void depthFirst(NodeView subTree, Visitor visit) const;
+    
+    // Traversal helper methods:
     void preorder(void visit(ItemType&),
-                  BinaryNodePtr treePtr);
+                  NodeView subTree);
     void inorder(void visit(ItemType&),
-                 BinaryNodePtr treePtr);
+                 NodeView subTree);
     void postorder(void visit(ItemType&),
-                   BinaryNodePtr treePtr);
+                   NodeView subTree);
+    // Recomputes every hash below subTree, children first.
+    void refreshHashes(NodeView subTree);
+    
+    // Held by the traversals that let visit change items. It sets the
+    // membership filter aside for the walk and refills it afterwards.
+    // If visit throws, it also recomputes every hash, since the walk
+    // stopped before refreshing the ancestors of the nodes it changed.
+    // A filter that cannot be refilled is dropped, which only costs
+    // speed.
+    class MutableVisitGuard {
+    public:
+        explicit MutableVisitGuard(BinaryNodeTree& tree)
+        : tree(tree),
+          filter(std::move(tree.membershipFilter) ),
+          pendingExceptions(std::uncaught_exceptions() ) {}
+        
+        MutableVisitGuard(const MutableVisitGuard&) = delete;
+        MutableVisitGuard& operator=(const MutableVisitGuard&) = delete;
+        
+        ~MutableVisitGuard() {
+            try {
+                if (std::uncaught_exceptions() > pendingExceptions) {
+                    tree.refreshHashes(tree.rootView() );
+                }
+                tree.membershipFilter = std::move(filter);
+                tree.rebuildMembershipFilter();
+            }
+            catch (const std::bad_alloc&) {
+                tree.membershipFilter.reset();
+            }
+        }
+        
+    private:
+        BinaryNodeTree& tree;
+        std::shared_ptr<CountingBloomFilter> filter;
+        int pendingExceptions;
+    };
+    
+    // Calls visit(item) for every item below node, in preorder.
+    template <typename Visitor>
+    void forEachItem(NodeView node, Visitor& visit) const;
+    
+    // Marks the tree as changed, invalidating cached snapshots. Const
+    // because adaptive promotions change the item order inside const
+    // lookups.
+    void touch() const;
+    
+    // Counts the downward paths summing to target with running prefix
+    // sums; stops at the first one if stopAtFirst.
+    template <typename Accumulator>
+    std::size_t downwardPathSumHelper(const Accumulator& target,
+                                      bool stopAtFirst) const;
+    
+    // Rebuilds the ancestor index if the tree changed since the last
+    // ancestor query.
+    void refreshAncestorIndex() const;
+    
+    // Preorder position of the first node whose key matches anEntry's.
+    // @throws NotFoundException If the tree does not contain anEntry.
+    std::uint32_t ancestorPosition(const ItemType& anEntry,
+                                   const char* caller) const;
+    
+#ifdef TREE_GENERATORS
+    // Generator support: throws if the tree was modified since the
+    // generator started.
+    void checkUnchanged(unsigned long long startVersion,
+                        const char* caller) const;
+#endif
+    
+    // The membership filter, cloned first if another tree shares it;
+    // null if the filter is disabled.
+    CountingBloomFilter* writableFilter();
+    
+    // Refills the membership filter from the items, if it is enabled.
+    void rebuildMembershipFilter();
+    
+    // False if the membership filter proves no item has this key.
+    // The filter holds keyHash of every item.
+    template <typename KeyType>
+    bool mayContain(const KeyType& key) const;
+    static std::size_t keyHash(const ItemType& anItem);
+    static constexpr bool keysHashed = HasKeyHash<ItemType>::value;
+    
+    // Adaptive layout support. recordLookup is called after each
+    // public lookup, flattened or not, with the item found (or null),
+    // and promotes when the period runs out. promoteHotItemsHelper
+    // clones any nodes shared with a copy first, as the mutators do.
+    void recordLookup(const ItemType* found) const;
+    void promoteHotItemsHelper() const;
+    
+    // Merge and split support. releaseNodes empties the tree and
+    // returns its nodes in inorder, unlinked and unflipped; nodes no
+    // other tree shares are reused, the rest are cloned.
+    // buildBalanced links nodes[low, high) into a minimum-height tree
+    // with the same inorder.
+    std::vector<BinaryNodePtr> releaseNodes();
+    void collectNodes(const BinaryNodePtr& subTreePtr,
+                      bool mirrored,
+                      std::vector<BinaryNodePtr>& nodes);
+    static BinaryNodePtr buildBalanced(const std::vector<BinaryNodePtr>& nodes,
+                                       std::size_t low,
+                                       std::size_t high);
     
     // Tools for manipulating BinaryNodes:
     
-    bool isLeaf(const BinaryNodePtr nodePtr) const;
+    bool isLeaf(const BinaryNodePtr& nodePtr) const;
+    
+    // Lazy flip support: a node's flipped flag mirrors its subtree.
+    // childOf reads the logical left (right == false) or right child
+    // of a node seen with the given parity; childSlot is the writable
+    // form used by the mutators.
+    static const BinaryNodePtr& childOf(const BinaryNode& node,
+                                        bool mirrored,
+                                        bool right);
+    static BinaryNodePtr& childSlot(BinaryNode& node,
+                                    bool mirrored,
+                                    bool right);
+    // Moves a pending flip into the root node's own flag.
+    BinaryNodePtr pushDownFlip(const BinaryNodePtr& subTreePtr,
+                               bool mirrored) const;
     
+    NodeView rootView() const;
+    // Moves a pending whole-tree flip into the root once, cloning the
+    // root only if it is shared, so later calls return it as is.
+    BinaryNodePtr getRootPtr();
+    // A const tree cannot take the flip itself, so while it is
+    // mirrored each call returns a fresh clone of the root holding it.
     BinaryNodePtr getRootPtr() const;
     void setRootPtr(BinaryNodePtr newRootPtr);
     
     //Display
-    void display(BinaryNodePtr RootPtrSit);
+    void display(const BinaryNodePtr& RootPtrSit);
     //Tree Helper Display
-    void treeHelperDisplay(BinaryNodePtr RootPtrSit,int height) const;
-    //flip function
-    void fliphelper(BinaryNodePtr rootPtr);
-    //flip display
-    void flipHelperDisplay(BinaryNodePtr RootPtr,ItemType arry[],long unsigned int numFlipCount);
+    void treeHelperDisplay(NodeView RootPtrSit,int height) const;
     //BST Helper
-    bool BSTHelper(BinaryNodePtr rootPtr,int min,int max);
+    bool BSTHelper(NodeView rootPtr,long long min,long long max);
     //BST GetMaxHelper
-    int getMaxHelper(BinaryNodePtr rootPtr, int max);
+    int getMaxHelper(NodeView rootPtr, int max);
     //BST GetMinHelper
-    int getMinHelper(BinaryNodePtr rootPtr, int min);
+    int getMinHelper(NodeView rootPtr, int min);
     int min(const ItemType& ,const ItemType&);
     int max(const ItemType& , const ItemType&);
     //Print RootLeafHelper
-    void printRootHelper(BinaryNodePtr rootPtr, ItemType arry[], long unsigned int indexPrint);
+    void printRootHelper(NodeView rootPtr, ItemType arry[], long unsigned int indexPrint);
     //doesSomePathHaveSome Helper
-    void doesSomePathHaveSumHelper(BinaryNodePtr rootPtr,ItemType arry[],long unsigned int height, int value, bool& statusCheck);
+    void doesSomePathHaveSumHelper(NodeView rootPtr,ItemType arry[],long unsigned int height, int value, bool& statusCheck);
     //doesTestPathArray
     bool testPathArray(ItemType arry[], long unsigned int length, int sum);
+    
+    // Merkle hashing: the hash of a node covers its item and the
+    // hashes of both children, so equal hashes mean (with high
+    // probability) equal subtrees. Items that std::hash cannot hash
+    // count as 0, so the hashes then cover the shape alone: unequal
+    // hashes still prove the trees differ, but equal ones prove
+    // nothing, and operator== and diff compare every item instead.
+    static constexpr bool hashesItems =
+        std::is_default_constructible<std::hash<ItemType>>::value &&
+        std::is_invocable_r<std::size_t, const std::hash<ItemType>&, const ItemType&>::value;
+    static std::size_t hashItem(const ItemType& anItem);
+    static std::size_t subtreeHashOf(const BinaryNodePtr& nodePtr,
+                                     bool mirrored);
+    static std::size_t combineHash(const BinaryNode& node,
+                                   bool mirrored);
+    static void refreshHash(const BinaryNodePtr& nodePtr);
+    static void refreshHash(BinaryNode* nodePtr);
 
 public:
     //------------------------------------------------------------
@@ -143,17 +455,99 @@ public:
     
     bool contains(const ItemType& anEntry) const override;
     
+    // Heterogeneous lookup: the first item in preorder whose key
+    // equals key, without building an ItemType to compare with. For
+    // example, a tree of std::string takes a std::string_view or a C
+    // string, and a record type takes whatever key its LookupTraits
+    // specialization names.
+    template <typename KeyType, typename = EnableIfLookupKey<KeyType>>
+    bool contains(const KeyType& key) const;
+    template <typename KeyType, typename = EnableIfLookupKey<KeyType>>
+    ItemType getEntry(const KeyType& key) const;
+    
     //------------------------------------------------------------
     // Public Traversals Section.
     //------------------------------------------------------------
     void preorderTraverse(void visit(ItemType&) ) override;
     void inorderTraverse(void visit(ItemType&) ) override;
     void postorderTraverse(void visit(ItemType&) ) override;
+    void levelorderTraverse(void visit(ItemType&) ) override;
+    
+    // Width, sum, minimum and maximum of the items at one depth.
+    struct LevelStats {
+        std::size_t width;
+        ItemType sum;
+        ItemType min;
+        ItemType max;
+    };
+    
+    // Per-depth statistics gathered in one breadth-first pass; the
+    // size of the result is the height of the tree.
+    std::vector<LevelStats> levelStats() const;
+    
+    // Shape metrics. Depths and lengths count edges; the height
+    // counts nodes, as in getHeight. A node's balance factor is the
+    // height of its left subtree minus that of its right subtree.
+    struct ShapeReport {
+        int height = 0;
+        std::size_t nodes = 0;
+        std::size_t leaves = 0;
+        // Longest path between any two nodes.
+        int diameter = 0;
+        // Most nodes at one depth, and the shallowest such depth.
+        std::size_t maxWidth = 0;
+        int widestDepth = 0;
+        // Sum of the depths of all nodes.
+        unsigned long long internalPathLength = 0;
+        // Number of nodes with each balance factor.
+        std::map<int, std::size_t> balanceFactors;
+    };
+    
+    // All of the above in one iterative postorder pass, without
+    // recursion or per-call allocation beyond the result.
+    ShapeReport shapeReport() const;
+    
+    // Batched level order: calls visit(depth, items, count) once per
+    // level, with the items of that level in one contiguous array.
+    template <typename Visitor>
+    void levelorderFrontiers(Visitor visit) const;
+    
+#ifdef TREE_GENERATORS
+    // Lazy traversals (C++20 only). Each resume does O(1) amortized
+    // work, and the only extra memory is an explicit stack of at most
+    // height entries. A yielded reference stays valid until the next
+    // value is requested. Modifying the tree while a generator is
+    // live makes its next resume throw PrecondViolatedExcep.
+    Generator<ItemType> inorder() const;
+    Generator<ItemType> preorder() const;
+    // Yields each root-to-leaf path, left to right.
+    Generator<std::vector<ItemType>> rootToLeafPaths() const;
+#endif
     
     //------------------------------------------------------------
     // Overloaded Operator Section.
     //------------------------------------------------------------
     BinaryNodeTree& operator=(const BinaryNodeTree& rhs);
+    
+    // Content equality: same shape and equal items at every position.
+    // Trees with different root hashes are rejected in O(1); otherwise
+    // one lockstep walk stops at the first mismatch.
+    bool operator==(const BinaryNodeTree& rhs) const;
+    bool operator!=(const BinaryNodeTree& rhs) const;
+    //------------------------------------------------------------
+    // Structural equality, hashing and diff.
+    //------------------------------------------------------------
+    // True if both trees have the same shape, ignoring the items.
+    bool sameShape(const BinaryNodeTree& other) const;
+    // Merkle hash of the whole tree, maintained incrementally. It
+    // covers only the shape if std::hash cannot hash ItemType.
+    std::size_t hash() const;
+    // Paths of the topmost subtrees that differ from other, found by
+    // descending only where subtree hashes disagree (or, for items
+    // std::hash cannot hash, wherever the subtrees are not shared).
+    // A path is a string of 'L' and 'R' moves from the root; "" is
+    // the root.
+    std::vector<std::string> diff(const BinaryNodeTree& other) const;
     //------------------------------------------------------------
     // Display contents of the Binary Tree
     //------------------------------------------------------------
@@ -183,6 +577,154 @@ public:
     // Test If Path Sums to Sum.
     //------------------------------------------------------------
     bool doesSomePathHaveSum(int value);
+    //------------------------------------------------------------
+    // Downward path sums: paths that start at any node and go down
+    // to any descendant (or stop at the node itself). Each query is
+    // one O(n) pass keeping a hash multiset of the prefix sums on the
+    // current root path. Sums are accumulated in the
+    // PathSumTraits accumulator unless another is given.
+    //
+    // @throws std::overflow_error If an integer sum overflows.
+    //------------------------------------------------------------
+    template <typename Accumulator = typename PathSumTraits<ItemType>::type>
+    bool hasDownwardPathSum(const Accumulator& target) const;
+    template <typename Accumulator = typename PathSumTraits<ItemType>::type>
+    std::size_t countDownwardPathSums(const Accumulator& target) const;
+    //------------------------------------------------------------
+    // Merge and split in O(n). The results are rebuilt balanced
+    // (minimum height) from the existing nodes, keeping the inorder
+    // sequence, so nothing is reallocated unless shared with another
+    // tree.
+    //------------------------------------------------------------
+    // Moves every item of other into this tree, after this tree's
+    // items in inorder, and leaves other empty.
+    void merge(BinaryNodeTree& other);
+    // Keeps the first k items in inorder and returns the rest.
+    BinaryNodeTree splitAt(std::size_t k);
+    // Moves the items for which pred(item) is true into the returned
+    // tree and keeps the others.
+    template <typename Predicate>
+    BinaryNodeTree partition(Predicate pred);
+    //------------------------------------------------------------
+    // Exact reconstruction from traversal sequences, and matching
+    // exporters. Builders replace the contents of this tree and read
+    // each sequence once, front to back, so input iterators over
+    // streams work without buffering the input. Apart from the new
+    // nodes they keep O(height) (preorder plus inorder) or O(width)
+    // (level order) of state. Exporters write through any output
+    // iterator and see the tree through pending flips.
+    //
+    // @throws PrecondViolatedExcep If the sequences do not describe a
+    //         tree; this tree is then left unchanged.
+    //------------------------------------------------------------
+    // Items must be distinct, since otherwise preorder and inorder
+    // do not determine the shape.
+    template <typename PreorderIterator, typename InorderIterator>
+    void buildFromTraversals(PreorderIterator preorderFirst,
+                             PreorderIterator preorderLast,
+                             InorderIterator inorderFirst,
+                             InorderIterator inorderLast);
+    // Level order with an empty optional for each missing child of
+    // a present node; trailing empties may be omitted.
+    template <typename InputIterator>
+    void buildFromLevelorder(InputIterator first, InputIterator last);
+    // The shape that calling add on each item in turn gives an empty
+    // tree, planned on index arrays first so that each node is built
+    // once rather than copied down a path per add. O(n log n), since
+    // add keeps every node's subtree heights within one of each other.
+    template <typename InputIterator>
+    void buildFromAdds(InputIterator first, InputIterator last);
+    template <typename OutputIterator>
+    OutputIterator exportPreorder(OutputIterator out) const;
+    template <typename OutputIterator>
+    OutputIterator exportInorder(OutputIterator out) const;
+    // Writes std::optional<ItemType> values in the format
+    // buildFromLevelorder reads, without trailing empties.
+    template <typename OutputIterator>
+    OutputIterator exportLevelorder(OutputIterator out) const;
+    //------------------------------------------------------------
+    // Non-throwing variants. Where the methods above throw
+    // NotFoundException or PrecondViolatedExcep on a miss or an empty
+    // tree, these return an empty optional (or false) instead, at the
+    // cost of a branch rather than an exception unwind.
+    //------------------------------------------------------------
+    std::optional<ItemType> tryGetEntry(const ItemType& anEntry) const;
+    template <typename KeyType, typename = EnableIfLookupKey<KeyType>>
+    std::optional<ItemType> tryGetEntry(const KeyType& key) const;
+    std::optional<ItemType> tryGetRootData() const;
+    std::optional<int> tryGetMax();
+    std::optional<int> tryGetMin();
+    // False if the tree is empty, in which case nothing is printed.
+    bool tryPrintRootLeaf();
+    std::optional<bool> tryDoesSomePathHaveSum(int value);
+    //------------------------------------------------------------
+    // Membership filter. When enabled, contains and getEntry reject
+    // most absent items with one cache-line probe instead of a full
+    // walk. Every mutator keeps the filter exact for present items,
+    // so it never rejects an item that is in the tree. It is sized
+    // for expectedItems at the given false-positive rate, capped at
+    // maxBytes if that is not zero; the rate degrades gracefully once
+    // the tree outgrows expectedItems. LookupTraits must provide a
+    // hash of the item keys.
+    //------------------------------------------------------------
+    void enableMembershipFilter(std::size_t expectedItems,
+                                double falsePositiveRate = 0.01,
+                                std::size_t maxBytes = 0);
+    void disableMembershipFilter();
+    // Memory used by the filter; 0 when it is disabled.
+    std::size_t membershipFilterBytes() const;
+    //------------------------------------------------------------
+    // Adaptive layout. findNode searches in preorder, so a lookup
+    // visits every node before the first match. When enabled,
+    // contains and getEntry count their hits, and every period
+    // lookups the most-hit items are swapped into the first preorder
+    // positions (the root, then down the left spine), hottest first.
+    // Only items move; the shape is unchanged. Counts are halved at
+    // each promotion so the layout follows a shifting workload.
+    //
+    // A promotion reorders the items inside a const lookup: it
+    // invalidates flatten() and live generators, and an adaptive
+    // tree must not be read from several threads at once. Nodes
+    // shared with a copy are cloned first, so the copy is unaffected.
+    // Items are counted by the hash of their keys, so LookupTraits
+    // must provide a hash.
+    //
+    // @throws PrecondViolatedExcep If period is 0.
+    //------------------------------------------------------------
+    void enableAdaptiveLayout(std::size_t period = 4096);
+    void disableAdaptiveLayout();
+    bool isAdaptiveLayoutEnabled() const;
+    // Promotes now, cloning shared nodes first.
+    void promoteHotItems();
+    //------------------------------------------------------------
+    // Ancestor queries. An item stands for its first node in
+    // preorder, as in getEntry. The first query after a mutation
+    // builds an O(n log n) index; later queries are O(1). Safe to
+    // call from several threads at once, like the other const reads.
+    //
+    // @throws NotFoundException If either item is not in the tree.
+    //------------------------------------------------------------
+    // Item of the deepest node that is an ancestor of (or is) both.
+    ItemType lowestCommonAncestor(const ItemType& first,
+                                  const ItemType& second) const;
+    // Number of edges on the path between the two nodes.
+    int distance(const ItemType& first, const ItemType& second) const;
+    //------------------------------------------------------------
+    // Vectorized reductions. flatten() copies the items into one
+    // contiguous array; until the next mutation, getMin, getMax, sum,
+    // countIf and contains scan that array with SIMD kernels (for
+    // arithmetic item types) instead of walking the nodes.
+    //------------------------------------------------------------
+    void flatten();
+    bool isFlattened() const;
+    typename SimdSum<ItemType>::type sum() const;
+    template <typename Predicate>
+    std::size_t countIf(Predicate pred) const;
+    //------------------------------------------------------------
+    // Instrumentation counters (all zero unless BINARY_TREE_STATS).
+    //------------------------------------------------------------
+    TreeStats stats() const;
+    void resetStats();
 };
 
 #include "BinaryNode.h"
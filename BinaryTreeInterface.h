@@ -135,6 +135,19 @@ public:
     virtual void preorderTraverse(void visit(ItemType&) ) = 0;
     virtual void inorderTraverse(void visit(ItemType&) ) = 0;
     virtual void postorderTraverse(void visit(ItemType&) ) = 0;
+    
+    /** Traverses this binary tree in level order (breadth first, left
+     *  to right within a level) and calls the function visit once for
+     *  each node.
+     *
+     *  @pre None.
+     *
+     *  @post The function visit has been called once per node. This
+     *        call can alter the data stored in this binary tree.
+     *
+     *  @param visit A client-defined function that will perform some
+     *               operation on the data in a node. */
+    virtual void levelorderTraverse(void visit(ItemType&) ) = 0;
 };
 
 #endif
@@ -0,0 +1,183 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a blocked counting Bloom filter.
+ *
+ *  Every key maps to one cache-line block of 64 eight-bit counters and
+ *  to hashCount() counters inside it, so a lookup touches one cache
+ *  line. Counters make erase possible; a counter that reaches 255
+ *  saturates and is never decremented again, which can only cause
+ *  false positives, never false negatives.
+ *
+ *  The filter works on precomputed hashes. Callers must erase only
+ *  hashes they inserted.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef COUNTING_BLOOM_FILTER_
+#define COUNTING_BLOOM_FILTER_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @class CountingBloomFilter CountingBloomFilter.h "CountingBloomFilter.h"
+ *
+ *  Approximate multiset membership with insert and erase. */
+class CountingBloomFilter {
+public:
+    static constexpr std::size_t countersPerBlock = 64;
+
+    /** Sizes the filter for expectedItems keys at the given false
+     *  positive rate. If maxBytes is not zero the filter is shrunk to
+     *  fit it, and the false-positive rate rises to match. */
+    CountingBloomFilter(std::size_t expectedItems,
+                        double falsePositiveRate,
+                        std::size_t maxBytes = 0) {
+        const double items(static_cast<double>(std::max<std::size_t>(expectedItems, 1) ) );
+        const double rate(std::min(std::max(falsePositiveRate, 1e-9), 0.5) );
+        const double ln2(std::log(2.0) );
+        const std::size_t blockLimit(maxBytes != 0 ? std::max<std::size_t>(maxBytes / sizeof(Block), 1)
+                                                   : ~std::size_t(0) );
+
+        // Start from the classic (unblocked) size, then grow until the
+        // blocked estimate meets the rate: uneven block loads make a
+        // blocked filter need noticeably more counters.
+        auto counters(std::ceil(-items * std::log(rate) / (ln2 * ln2) ) );
+        std::size_t blockCount(0);
+        for (;;) {
+            blockCount = std::min(std::max<std::size_t>(static_cast<std::size_t>(
+                                      std::ceil(counters / countersPerBlock) ), 1),
+                                  blockLimit);
+            probes = optimalProbes(items, blockCount);
+            if (blockCount == blockLimit || expectedRate(items, blockCount, probes) <= rate) {
+                break;
+            }
+            counters *= 1.1;
+        }
+        blocks.resize(blockCount);
+    }
+
+    void insert(std::size_t hash) {
+        auto& block(blockFor(hash) );
+        forEachProbe(hash, [&block](std::size_t slot) {
+            if (block.counters[slot] != saturated) {
+                ++block.counters[slot];
+            }
+        });
+    }
+
+    void erase(std::size_t hash) {
+        auto& block(blockFor(hash) );
+        forEachProbe(hash, [&block](std::size_t slot) {
+            if (block.counters[slot] != saturated && block.counters[slot] != 0) {
+                --block.counters[slot];
+            }
+        });
+    }
+
+    /** @return False only if hash was never inserted (or was erased
+     *          as often as inserted). */
+    bool mayContain(std::size_t hash) const {
+        const auto& block(blockFor(hash) );
+        bool present(true);
+        forEachProbe(hash, [&block, &present](std::size_t slot) {
+            present = present && block.counters[slot] != 0;
+        });
+        return present;
+    }
+
+    void clear() { std::fill(blocks.begin(), blocks.end(), Block() ); }
+
+    std::size_t sizeInBytes() const { return blocks.size() * sizeof(Block); }
+    unsigned int hashCount() const { return probes; }
+
+private:
+    static constexpr std::uint8_t saturated = 255;
+
+    struct alignas(64) Block {
+        std::uint8_t counters[countersPerBlock] = {};
+    };
+
+    // std::hash is the identity for integers, so spread the bits
+    // before using them (splitmix64 finalizer).
+    static std::uint64_t mix(std::size_t hash) {
+        std::uint64_t bits(hash);
+        bits = (bits ^ (bits >> 30) ) * 0xbf58476d1ce4e5b9ULL;
+        bits = (bits ^ (bits >> 27) ) * 0x94d049bb133111ebULL;
+        return bits ^ (bits >> 31);
+    }
+
+    // High 64 bits of lhs * rhs. Where there is no 128-bit integer,
+    // the product is assembled from 32-bit halves.
+    static std::uint64_t multiplyHigh(std::uint64_t lhs, std::uint64_t rhs) {
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 Wide;
+        return static_cast<std::uint64_t>( (static_cast<Wide>(lhs) * rhs) >> 64);
+#else
+        const std::uint64_t low(0xffffffffULL);
+        const std::uint64_t lowLow( (lhs & low) * (rhs & low) );
+        const std::uint64_t highLow( (lhs >> 32) * (rhs & low) + (lowLow >> 32) );
+        const std::uint64_t lowHigh( (lhs & low) * (rhs >> 32) + (highLow & low) );
+        return (lhs >> 32) * (rhs >> 32) + (highLow >> 32) + (lowHigh >> 32);
+#endif
+    }
+
+    // Maps the hash onto [0, blocks) by multiplying rather than by a
+    // modulo, which would cost a division.
+    Block& blockFor(std::size_t hash) {
+        return blocks[static_cast<std::size_t>(multiplyHigh(mix(hash), blocks.size() ) )];
+    }
+    const Block& blockFor(std::size_t hash) const {
+        return const_cast<CountingBloomFilter*>(this)->blockFor(hash);
+    }
+
+    // Each probe takes its own 6 bits of a second hash (a fresh one
+    // every 10 probes), so keys sharing a block rarely share all of
+    // their counters.
+    template <typename Visitor>
+    void forEachProbe(std::size_t hash, Visitor visit) const {
+        std::uint64_t bits(0);
+        for (unsigned int i(0); i < probes; ++i) {
+            if (i % 10 == 0) {
+                bits = mix(hash + 0x9e3779b97f4a7c15ULL * (i / 10 + 1) );
+            }
+            visit(bits & (countersPerBlock - 1) );
+            bits >>= 6;
+        }
+    }
+
+    static unsigned int optimalProbes(double items, std::size_t blockCount) {
+        const double perItem(static_cast<double>(blockCount * countersPerBlock) / items);
+        return static_cast<unsigned int>(std::min(std::max(std::lround(perItem * std::log(2.0) ), 1L),
+                                                  16L) );
+    }
+
+    // False-positive rate of a blocked filter: the number of keys in
+    // the probed block is Poisson distributed.
+    static double expectedRate(double items, std::size_t blockCount, unsigned int probeCount) {
+        const double load(items / static_cast<double>(blockCount) );
+        const double missPerKey(std::pow(1.0 - 1.0 / countersPerBlock, probeCount) );
+        double rate(0.0);
+        double weight(std::exp(-load) );
+        const double last(load + 10.0 * std::sqrt(load) + 10.0);
+        for (double keys(0.0); keys <= last; ++keys) {
+            rate += weight * std::pow(1.0 - std::pow(missPerKey, keys), probeCount);
+            weight *= load / (keys + 1.0);
+        }
+        return rate;
+    }
+
+    std::vector<Block> blocks;
+    unsigned int probes;
+};
+
+#endif
@@ -0,0 +1,519 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for a BinaryNodeTree that survives crashes by
+ *  journaling its mutations to disk.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "PrecondViolatedExcep.h"
+
+//////////////////////////////////////////////////////////////
+//      Protected File Helpers Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+std::uint64_t DurableBinaryTree<ItemType>::checksum(const unsigned char* bytes,
+                                                    std::size_t count,
+                                                    std::uint64_t seed) {
+
+    // FNV-1a; seed chains several buffers into one checksum.
+    for (std::size_t i(0); i < count; ++i) {
+        seed = (seed ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return seed;
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::ioError(const char* what, const std::string& path) {
+
+    std::string message("DurableBinaryTree: cannot ");
+    message += what;
+    message += " ";
+    message += path;
+    message += ".";
+    throw std::runtime_error(message);
+}
+
+template <typename ItemType>
+bool DurableBinaryTree<ItemType>::readBytes(std::FILE* file, void* bytes, std::size_t count) {
+
+    return std::fread(bytes, 1, count, file) == count;
+}
+
+template <typename ItemType>
+bool DurableBinaryTree<ItemType>::writeBytes(std::FILE* file, const void* bytes, std::size_t count) {
+
+    return std::fwrite(bytes, 1, count, file) == count;
+}
+
+template <typename ItemType>
+bool DurableBinaryTree<ItemType>::syncFile(std::FILE* file) {
+
+    return std::fflush(file) == 0 && ::fsync(::fileno(file) ) == 0;
+}
+
+//////////////////////////////////////////////////////////////
+//      Protected Journal Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::append(Op op, const ItemType* anItem) {
+
+    pending.push_back(static_cast<unsigned char>(op) );
+    if (anItem) {
+        const auto bytes(reinterpret_cast<const unsigned char*>(anItem) );
+        pending.insert(pending.end(), bytes, bytes + sizeof(ItemType) );
+    }
+    if (++pendingCount >= groupSize) {
+        commit();
+    }
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::replay(Op op, const ItemType* anItem) {
+
+    switch (op) {
+        case Op::Add:
+            tree.add(*anItem);
+            break;
+        case Op::Remove:
+            tree.remove(*anItem);
+            break;
+        case Op::SetRootData:
+            tree.setRootData(*anItem);
+            break;
+        case Op::Flip:
+            tree.flip();
+            break;
+    }
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::loadCheckpoint() {
+
+    std::FILE* file(std::fopen(checkpointPath.c_str(), "rb") );
+    if (!file) {
+        return; // Nothing checkpointed yet.
+    }
+
+    // Header: magic, item size, generation, node count.
+    unsigned char header[checkpointHeaderSize] = {};
+    std::uint32_t itemSize(0);
+    std::uint64_t count(0);
+    std::uint64_t fileGeneration(0);
+    long fileSize(-1);
+    if (readBytes(file, header, sizeof(header) ) &&
+        std::fseek(file, 0, SEEK_END) == 0) {
+        fileSize = std::ftell(file);
+        std::memcpy(&itemSize, header + 4, sizeof(itemSize) );
+        std::memcpy(&fileGeneration, header + 8, sizeof(fileGeneration) );
+        std::memcpy(&count, header + 16, sizeof(count) );
+    }
+    // The size check keeps a damaged count from causing a huge
+    // allocation.
+    const std::uint64_t shapeBytes( (count + 3) / 4);
+    if (std::memcmp(header, checkpointMagic, 4) != 0 || itemSize != sizeof(ItemType) ||
+        fileSize < 0 || count > static_cast<std::uint64_t>(fileSize) ||
+        static_cast<std::uint64_t>(fileSize) !=
+            checkpointHeaderSize + count * sizeof(ItemType) + shapeBytes + sizeof(std::uint64_t) ) {
+        std::fclose(file);
+        ioError("recover from damaged checkpoint", checkpointPath);
+    }
+
+    std::vector<ItemType> items(count);
+    std::vector<unsigned char> shape(shapeBytes);
+    std::uint64_t storedChecksum(0);
+    const bool intact(std::fseek(file, checkpointHeaderSize, SEEK_SET) == 0 &&
+                      readBytes(file, items.data(), items.size() * sizeof(ItemType) ) &&
+                      readBytes(file, shape.data(), shape.size() ) &&
+                      readBytes(file, &storedChecksum, sizeof(storedChecksum) ) );
+    std::fclose(file);
+    auto sum(checksum(reinterpret_cast<const unsigned char*>(items.data() ),
+                      items.size() * sizeof(ItemType) ) );
+    sum = checksum(shape.data(), shape.size(), sum);
+    if (!intact || sum != storedChecksum) {
+        ioError("recover from damaged checkpoint", checkpointPath);
+    }
+
+    // Relink the nodes in preorder. parents holds the nodes still
+    // waiting for a child; the next node is the first missing child
+    // of the top one.
+    using BinaryNode = typename BinaryNodeTree<ItemType>::BinaryNode;
+    struct Parent {
+        BinaryNode* node;
+        bool needsLeft;
+        bool needsRight;
+    };
+    std::vector<Parent> parents;
+    std::vector<BinaryNode*> order;
+    order.reserve(items.size() );
+    std::shared_ptr<BinaryNode> newRootPtr;
+    bool wellFormed(true);
+    for (std::size_t i(0); i < items.size() && wellFormed; ++i) {
+        auto nodePtr(std::make_shared<BinaryNode>(items[i]) );
+        if (i == 0) {
+            newRootPtr = nodePtr;
+        }
+        else if (parents.empty() ) {
+            wellFormed = false;
+        }
+        else {
+            auto& parent(parents.back() );
+            if (parent.needsLeft) {
+                parent.node->leftChildPtr = nodePtr;
+                parent.needsLeft = false;
+            }
+            else {
+                parent.node->rightChildPtr = nodePtr;
+                parent.needsRight = false;
+            }
+            if (!parent.needsLeft && !parent.needsRight) {
+                parents.pop_back();
+            }
+        }
+        const unsigned bits( (shape[i / 4] >> (2 * (i % 4) ) ) & 3u);
+        if (bits != 0) {
+            parents.push_back({nodePtr.get(), (bits & 1u) != 0, (bits & 2u) != 0});
+        }
+        order.push_back(nodePtr.get() );
+    }
+    if (!wellFormed || !parents.empty() ) {
+        ioError("recover from damaged checkpoint", checkpointPath);
+    }
+
+    // Descendants follow their ancestors in preorder, so hashing
+    // backwards sees children first.
+    for (auto node(order.rbegin() ); node != order.rend(); ++node) {
+        BinaryNodeTree<ItemType>::refreshHash(*node);
+    }
+    tree.setRootPtr(newRootPtr);
+    generation = fileGeneration;
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::recoverJournal() {
+
+    std::FILE* file(std::fopen(journalPath.c_str(), "rb") );
+    if (!file) {
+        startJournal();
+        return;
+    }
+
+    long fileSize(-1);
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        fileSize = std::ftell(file);
+    }
+    unsigned char header[journalHeaderSize] = {};
+    std::uint32_t itemSize(0);
+    std::uint64_t fileGeneration(0);
+    if (std::fseek(file, 0, SEEK_SET) == 0 && readBytes(file, header, sizeof(header) ) ) {
+        std::memcpy(&itemSize, header + 4, sizeof(itemSize) );
+        std::memcpy(&fileGeneration, header + 8, sizeof(fileGeneration) );
+    }
+    if (std::memcmp(header, journalMagic, 4) != 0 || itemSize != sizeof(ItemType) ||
+        fileGeneration != generation) {
+        // Unreadable, or already folded into the checkpoint.
+        std::fclose(file);
+        startJournal();
+        return;
+    }
+
+    // Batches: record count, byte count, checksum, records.
+    long validEnd(journalHeaderSize);
+    std::vector<unsigned char> batch;
+    for (;;) {
+        unsigned char batchHeader[batchHeaderSize];
+        std::uint32_t records(0);
+        std::uint32_t bytes(0);
+        std::uint64_t storedChecksum(0);
+        if (!readBytes(file, batchHeader, sizeof(batchHeader) ) ) {
+            break;
+        }
+        std::memcpy(&records, batchHeader, sizeof(records) );
+        std::memcpy(&bytes, batchHeader + 4, sizeof(bytes) );
+        std::memcpy(&storedChecksum, batchHeader + 8, sizeof(storedChecksum) );
+        if (static_cast<long>(bytes) > fileSize - validEnd - batchHeaderSize) {
+            break;
+        }
+        batch.resize(bytes);
+        if (!readBytes(file, batch.data(), batch.size() ) ||
+            checksum(batch.data(), batch.size() ) != storedChecksum) {
+            break;
+        }
+
+        // Check the whole batch before applying any of it.
+        std::size_t pos(0);
+        bool wellFormed(true);
+        for (std::uint32_t record(0); record < records && wellFormed; ++record) {
+            const auto op(pos < batch.size() ? batch[pos] : 0);
+            wellFormed = op >= static_cast<unsigned char>(Op::Add) &&
+                         op <= static_cast<unsigned char>(Op::Flip);
+            pos += 1 + (op == static_cast<unsigned char>(Op::Flip) ? 0 : sizeof(ItemType) );
+        }
+        if (!wellFormed || pos != batch.size() ) {
+            break;
+        }
+        for (pos = 0; pos < batch.size(); ) {
+            const auto op(static_cast<Op>(batch[pos++]) );
+            if (op == Op::Flip) {
+                replay(op, nullptr);
+                continue;
+            }
+            ItemType anItem;
+            std::memcpy(&anItem, batch.data() + pos, sizeof(ItemType) );
+            pos += sizeof(ItemType);
+            replay(op, &anItem);
+        }
+        validEnd += batchHeaderSize + static_cast<long>(bytes);
+    }
+    std::fclose(file);
+
+    // Drop a torn tail so that new batches follow the last good one.
+    if (validEnd < fileSize && ::truncate(journalPath.c_str(), validEnd) != 0) {
+        ioError("truncate", journalPath);
+    }
+    journal = std::fopen(journalPath.c_str(), "ab");
+    if (!journal) {
+        ioError("open", journalPath);
+    }
+    journalBytes = validEnd;
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::startJournal() {
+
+    if (journal) {
+        std::fclose(journal);
+    }
+    journal = std::fopen(journalPath.c_str(), "wb");
+    if (!journal) {
+        ioError("create", journalPath);
+    }
+
+    unsigned char header[journalHeaderSize];
+    const std::uint32_t itemSize(sizeof(ItemType) );
+    std::memcpy(header, journalMagic, 4);
+    std::memcpy(header + 4, &itemSize, sizeof(itemSize) );
+    std::memcpy(header + 8, &generation, sizeof(generation) );
+    if (!writeBytes(journal, header, sizeof(header) ) || !syncFile(journal) ) {
+        ioError("write", journalPath);
+    }
+    journalBytes = journalHeaderSize;
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor and Destructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+DurableBinaryTree<ItemType>::DurableBinaryTree(const std::string& basePath,
+                                               std::size_t groupSize)
+: journalPath(basePath + ".journal"),
+  checkpointPath(basePath + ".checkpoint"),
+  groupSize(groupSize) {
+
+    if (groupSize == 0) {
+        std::string message("DurableBinaryTree: groupSize ");
+        message += "must be positive.";
+        throw PrecondViolatedExcep(message);
+    }
+    loadCheckpoint();
+    recoverJournal();
+}
+
+template <typename ItemType>
+DurableBinaryTree<ItemType>::~DurableBinaryTree() {
+
+    try {
+        commit();
+    }
+    catch (const std::runtime_error&) {
+        // Destructors must not throw; the records are lost.
+    }
+    if (journal) {
+        std::fclose(journal);
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Journaled Mutators Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool DurableBinaryTree<ItemType>::add(const ItemType& newData) {
+
+    const bool added(tree.add(newData) );
+    if (added) {
+        append(Op::Add, &newData);
+    }
+    return added;
+}
+
+template <typename ItemType>
+bool DurableBinaryTree<ItemType>::remove(const ItemType& data) {
+
+    const bool removed(tree.remove(data) );
+    if (removed) {
+        append(Op::Remove, &data);
+    }
+    return removed;
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::setRootData(const ItemType& newData) {
+
+    tree.setRootData(newData);
+    append(Op::SetRootData, &newData);
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::flip() {
+
+    tree.flip();
+    append(Op::Flip, nullptr);
+}
+
+//////////////////////////////////////////////////////////////
+//      Durability Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::commit() {
+
+    if (pendingCount == 0) {
+        return;
+    }
+
+    unsigned char header[batchHeaderSize];
+    const auto records(static_cast<std::uint32_t>(pendingCount) );
+    const auto bytes(static_cast<std::uint32_t>(pending.size() ) );
+    const auto sum(checksum(pending.data(), pending.size() ) );
+    std::memcpy(header, &records, sizeof(records) );
+    std::memcpy(header + 4, &bytes, sizeof(bytes) );
+    std::memcpy(header + 8, &sum, sizeof(sum) );
+    if (!writeBytes(journal, header, sizeof(header) ) ||
+        !writeBytes(journal, pending.data(), pending.size() ) ||
+        !syncFile(journal) ) {
+        // Cut off the partial batch so that a later commit does not
+        // land behind it, where recovery would never reach.
+        // If that fails too, the checksum still stops recovery there.
+        std::fflush(journal);
+        if (::ftruncate(::fileno(journal), journalBytes) == 0) {
+            std::fseek(journal, journalBytes, SEEK_SET);
+        }
+        ioError("write", journalPath);
+    }
+    journalBytes += batchHeaderSize + static_cast<long>(pending.size() );
+    pending.clear();
+    pendingCount = 0;
+}
+
+template <typename ItemType>
+void DurableBinaryTree<ItemType>::checkpoint() {
+
+    commit();
+
+    const std::string tempPath(checkpointPath + ".tmp");
+    std::FILE* file(std::fopen(tempPath.c_str(), "wb") );
+    if (!file) {
+        ioError("create", tempPath);
+    }
+
+    const std::uint64_t nextGeneration(generation + 1);
+    const std::uint32_t itemSize(sizeof(ItemType) );
+    std::uint64_t count(0);
+    unsigned char header[checkpointHeaderSize];
+    std::memcpy(header, checkpointMagic, 4);
+    std::memcpy(header + 4, &itemSize, sizeof(itemSize) );
+    std::memcpy(header + 8, &nextGeneration, sizeof(nextGeneration) );
+    std::memcpy(header + 16, &count, sizeof(count) );
+    bool written(writeBytes(file, header, sizeof(header) ) );
+
+    // Items go out in preorder through a buffer; the shape is kept
+    // in memory (n / 4 bytes) and written after them.
+    using NodeView = typename BinaryNodeTree<ItemType>::NodeView;
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> shape;
+    std::vector<NodeView> stack;
+    std::uint64_t sum(checksum(nullptr, 0) );
+    if (!tree.isEmpty() ) {
+        stack.push_back(tree.rootView() );
+    }
+    while (!stack.empty() && written) {
+        auto node(stack.back() );
+        stack.pop_back();
+
+        const auto bytes(reinterpret_cast<const unsigned char*>(&node.item() ) );
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(ItemType) );
+        if (buffer.size() >= (1u << 20) ) {
+            sum = checksum(buffer.data(), buffer.size(), sum);
+            written = writeBytes(file, buffer.data(), buffer.size() );
+            buffer.clear();
+        }
+
+        const unsigned bits( (node.left() ? 1u : 0u) | (node.right() ? 2u : 0u) );
+        if (count % 4 == 0) {
+            shape.push_back(0);
+        }
+        shape.back() = static_cast<unsigned char>(shape.back() | (bits << (2 * (count % 4) ) ) );
+        ++count;
+
+        if (node.right() ) {
+            stack.push_back(node.right() );
+        }
+        if (node.left() ) {
+            stack.push_back(node.left() );
+        }
+    }
+    sum = checksum(buffer.data(), buffer.size(), sum);
+    sum = checksum(shape.data(), shape.size(), sum);
+    written = written &&
+              writeBytes(file, buffer.data(), buffer.size() ) &&
+              writeBytes(file, shape.data(), shape.size() ) &&
+              writeBytes(file, &sum, sizeof(sum) ) &&
+              std::fseek(file, 16, SEEK_SET) == 0 &&
+              writeBytes(file, &count, sizeof(count) ) &&
+              syncFile(file);
+    if (std::fclose(file) != 0 || !written ||
+        std::rename(tempPath.c_str(), checkpointPath.c_str() ) != 0) {
+        std::remove(tempPath.c_str() );
+        ioError("write", checkpointPath);
+    }
+
+    // Make the rename durable before the journal it replaces is
+    // emptied.
+    const auto slash(checkpointPath.rfind('/') );
+    const std::string directory(slash == std::string::npos ? "." : checkpointPath.substr(0, slash + 1) );
+    const int directoryFd(::open(directory.c_str(), O_RDONLY) );
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+
+    generation = nextGeneration;
+    startJournal();
+}
+
+template <typename ItemType>
+std::size_t DurableBinaryTree<ItemType>::pendingRecords() const {
+
+    return pendingCount;
+}
+
+template <typename ItemType>
+const BinaryNodeTree<ItemType>& DurableBinaryTree<ItemType>::getTree() const {
+
+    return tree;
+}
@@ -0,0 +1,159 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a BinaryNodeTree that survives crashes by
+ *  journaling its mutations to disk.
+ *
+ *  Two files share a base path. base.journal receives one compact
+ *  record per add, remove, setRootData and flip. Records are buffered
+ *  and written in batches with one fsync each (group commit).
+ *  base.checkpoint holds a full copy of the tree: the items in
+ *  preorder and 2 bits of shape per node. Recovery loads the
+ *  checkpoint and replays the journal written after it. Replaying the
+ *  same mutations on the same shape rebuilds the tree exactly.
+ *
+ *  Each file starts with a generation number. A checkpoint is written
+ *  to a temporary file and renamed into place, and only then is a new
+ *  journal started with the next generation. A journal whose
+ *  generation does not match the checkpoint was already folded into
+ *  it and is discarded. Every batch carries a checksum, and replay
+ *  stops at the first torn or damaged batch.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef DURABLE_BINARY_TREE_
+#define DURABLE_BINARY_TREE_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BinaryNodeTree.h"
+
+/** @class DurableBinaryTree DurableBinaryTree.h "DurableBinaryTree.h"
+ *
+ *  Journaled binary tree. The items are written as raw bytes, so
+ *  ItemType must be trivially copyable, and the files are only
+ *  readable on a machine with the same layout. I/O failures throw
+ *  std::runtime_error. Records still in the group buffer are lost on
+ *  a crash; call commit() to make them durable. */
+template <typename ItemType>
+class DurableBinaryTree {
+    static_assert(std::is_trivially_copyable<ItemType>::value,
+                  "DurableBinaryTree writes items as raw bytes.");
+
+public:
+    // Journal record types.
+    enum class Op : unsigned char {
+        Add = 1,
+        Remove,
+        SetRootData,
+        Flip
+    };
+
+private:
+    // File layouts (all integers little-endian as stored in memory):
+    //   checkpoint: magic, u32 item size, u64 generation, u64 count,
+    //               items, shape, u64 checksum of items and shape
+    //   journal:    magic, u32 item size, u64 generation, batches
+    //   batch:      u32 records, u32 bytes, u64 checksum, records
+    //   record:     Op, then the item unless the Op is Flip
+    static constexpr char checkpointMagic[5] = "BTC1";
+    static constexpr char journalMagic[5] = "BTJ1";
+    static constexpr long checkpointHeaderSize = 24;
+    static constexpr long journalHeaderSize = 16;
+    static constexpr long batchHeaderSize = 16;
+
+    BinaryNodeTree<ItemType> tree;
+
+    std::string journalPath;
+    std::string checkpointPath;
+    std::FILE* journal = nullptr;
+    // Length of the journal up to the last committed batch.
+    long journalBytes = 0;
+    std::uint64_t generation = 0;
+
+    // Records not yet written, and how many of them there are.
+    std::vector<unsigned char> pending;
+    std::size_t pendingCount = 0;
+    std::size_t groupSize;
+
+protected:
+    // File helpers. The read, write and sync helpers return false on
+    // failure; ioError throws std::runtime_error.
+    static std::uint64_t checksum(const unsigned char* bytes,
+                                  std::size_t count,
+                                  std::uint64_t seed = 0xcbf29ce484222325ULL);
+    [[noreturn]] static void ioError(const char* what, const std::string& path);
+    static bool readBytes(std::FILE* file, void* bytes, std::size_t count);
+    static bool writeBytes(std::FILE* file, const void* bytes, std::size_t count);
+    static bool syncFile(std::FILE* file);
+
+    // Buffers one record, committing if the group is full.
+    void append(Op op, const ItemType* anItem);
+
+    // Applies one record to the tree.
+    void replay(Op op, const ItemType* anItem);
+
+    // Loads the checkpoint, if there is one, into the tree.
+    void loadCheckpoint();
+
+    // Replays the journal if it belongs to the current generation,
+    // then reopens it for appending after the last intact batch.
+    void recoverJournal();
+
+    // Starts an empty journal for the current generation.
+    void startJournal();
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    // Opens (or creates) basePath.checkpoint and basePath.journal and
+    // recovers the tree they describe. Records are committed in
+    // groups of groupSize.
+    // @pre groupSize > 0.
+    explicit DurableBinaryTree(const std::string& basePath,
+                               std::size_t groupSize = 256);
+
+    DurableBinaryTree(const DurableBinaryTree&) = delete;
+    DurableBinaryTree& operator=(const DurableBinaryTree&) = delete;
+
+    // Commits pending records; errors are ignored here.
+    ~DurableBinaryTree();
+
+    //------------------------------------------------------------
+    // Journaled mutators, as in BinaryNodeTree. Only successful
+    // adds and removes are recorded.
+    //------------------------------------------------------------
+    bool add(const ItemType& newData);
+    bool remove(const ItemType& data);
+    void setRootData(const ItemType& newData);
+    void flip();
+
+    //------------------------------------------------------------
+    // Durability Section.
+    //------------------------------------------------------------
+    // Writes and fsyncs the pending records as one batch.
+    void commit();
+    // Writes the whole tree to a new checkpoint and empties the
+    // journal, so that recovery does not replay old records.
+    void checkpoint();
+    std::size_t pendingRecords() const;
+
+    // Read access to the tree. Mutations must go through this class
+    // to be journaled.
+    const BinaryNodeTree<ItemType>& getTree() const;
+};
+
+#include "DurableBinaryTree.cpp"
+
+#endif
@@ -0,0 +1,154 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a minimal lazy generator built on C++20 coroutines.
+ *
+ *  The generator suspends at every co_yield and resumes only when the
+ *  consumer asks for the next value, so a producer never runs ahead
+ *  of its consumer and several generators can be interleaved on one
+ *  thread. A yielded reference stays valid until the next resume.
+ *
+ *  Everything here is compiled only when the compiler supports
+ *  coroutines (e.g. -std=c++20), in which case TREE_GENERATORS is
+ *  defined.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef GENERATOR_
+#define GENERATOR_
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#define TREE_GENERATORS 1
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/** @class Generator Generator.h "Generator.h"
+ *
+ *  Move-only range of the values a coroutine yields. Use it in a
+ *  range-for, or pull values one at a time with next() and value(). */
+template <typename ValueType>
+class Generator {
+public:
+    struct promise_type {
+        const ValueType* current = nullptr;
+        std::exception_ptr exception;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this) );
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const ValueType& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        // Generators only yield; they never await.
+        template <typename Awaitable>
+        std::suspend_never await_transform(Awaitable&&) = delete;
+    };
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = ValueType;
+        using reference = const ValueType&;
+        using pointer = const ValueType*;
+
+        iterator() = default;
+
+        reference operator*() const { return *owner->coroutine.promise().current; }
+        pointer operator->() const { return owner->coroutine.promise().current; }
+
+        iterator& operator++() {
+            owner->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const {
+            return !owner || owner->coroutine.done();
+        }
+        bool operator!=(std::default_sentinel_t sentinel) const {
+            return !(*this == sentinel);
+        }
+
+    private:
+        friend class Generator;
+        explicit iterator(Generator* generator)
+        : owner(generator) {}
+
+        Generator* owner = nullptr;
+    };
+
+    Generator(Generator&& other) noexcept
+    : coroutine(std::exchange(other.coroutine, nullptr) ) {}
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+        return *this;
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator() { destroy(); }
+
+    /** Runs the producer up to its next value.
+     *
+     *  @return False once the producer has finished.
+     *
+     *  @throws Whatever the producer threw. */
+    bool next() {
+        if (!coroutine || coroutine.done() ) {
+            return false;
+        }
+        coroutine.resume();
+        if (coroutine.promise().exception) {
+            std::rethrow_exception(std::exchange(coroutine.promise().exception, nullptr) );
+        }
+        return !coroutine.done();
+    }
+
+    /** @pre The last call to next() returned true. */
+    const ValueType& value() const { return *coroutine.promise().current; }
+
+    iterator begin() {
+        next();
+        return iterator(this);
+    }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle)
+    : coroutine(handle) {}
+
+    void destroy() {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a lowest-common-ancestor index over a tree listed
+ *  in preorder.
+ *
+ *  Nodes are identified by their preorder position. For positions
+ *  a < b, the lowest common ancestor is the parent of the shallowest
+ *  node in (a, b], so a sparse table of range-minimum depths answers
+ *  each query in O(1) after O(n log n) preprocessing. Listing nodes
+ *  in preorder rather than as an Euler tour halves the table.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef LCA_INDEX_
+#define LCA_INDEX_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @class LcaIndex LcaIndex.h "LcaIndex.h"
+ *
+ *  Static LCA and distance queries by preorder position. */
+class LcaIndex {
+public:
+    static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+    void clear() {
+        depths.clear();
+        parents.clear();
+        levels.clear();
+    }
+
+    std::size_t size() const { return depths.size(); }
+
+    /** Appends the next node in preorder.
+     *
+     *  @param parent Position of the node's parent, or npos for the
+     *         root.
+     *
+     *  @return The position of the new node. */
+    std::uint32_t append(std::uint32_t parent) {
+        parents.push_back(parent);
+        depths.push_back(parent == npos ? 0 : depths[parent] + 1);
+        return static_cast<std::uint32_t>(depths.size() - 1);
+    }
+
+    /** Builds the sparse table; call after the last append. */
+    void build() {
+        levels.clear();
+        const std::size_t count(depths.size() );
+        for (std::size_t k(1); (std::size_t(1) << k) <= count; ++k) {
+            const std::size_t half(std::size_t(1) << (k - 1) );
+            levels.emplace_back(count - 2 * half + 1);
+            auto& level(levels.back() );
+            for (std::size_t i(0); i < level.size(); ++i) {
+                if (k == 1) {
+                    level[i] = shallower(static_cast<std::uint32_t>(i),
+                                         static_cast<std::uint32_t>(i + 1) );
+                }
+                else {
+                    const auto& previous(levels[k - 2]);
+                    level[i] = shallower(previous[i], previous[i + half]);
+                }
+            }
+        }
+    }
+
+    std::uint32_t depth(std::uint32_t position) const { return depths[position]; }
+
+    /** @pre Both positions are below size() and build() has been
+     *       called since the last append. */
+    std::uint32_t lowestCommonAncestor(std::uint32_t first, std::uint32_t second) const {
+        if (first == second) {
+            return first;
+        }
+        if (second < first) {
+            std::swap(first, second);
+        }
+        return parents[shallowestIn(first + 1, second)];
+    }
+
+    /** Number of edges on the path between two positions. */
+    std::uint32_t distance(std::uint32_t first, std::uint32_t second) const {
+        return depths[first] + depths[second]
+               - 2 * depths[lowestCommonAncestor(first, second)];
+    }
+
+private:
+    std::uint32_t shallower(std::uint32_t first, std::uint32_t second) const {
+        return depths[second] < depths[first] ? second : first;
+    }
+
+    // Shallowest position in [low, high].
+    std::uint32_t shallowestIn(std::uint32_t low, std::uint32_t high) const {
+        const std::size_t k(63 - __builtin_clzll(high - low + 1) );
+        if (k == 0) {
+            return low;
+        }
+        const auto& level(levels[k - 1]);
+        return shallower(level[low], level[high + 1 - (std::size_t(1) << k)]);
+    }
+
+    std::vector<std::uint32_t> depths;
+    std::vector<std::uint32_t> parents;
+
+    // levels[k - 1][i] is the shallowest position in [i, i + 2^k); the
+    // identity level k == 0 is not stored.
+    std::vector<std::vector<std::uint32_t>> levels;
+};
+
+#endif
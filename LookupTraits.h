@@ -0,0 +1,142 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for the key, equality and hash used by lookups.
+ *
+ *  contains, getEntry and remove compare items by key. By default the
+ *  key is the whole item, compared with == and hashed with std::hash,
+ *  so nothing changes for plain item types. A record type can
+ *  specialize LookupTraits to compare and hash one field instead. The
+ *  tree can then be searched with a bare key, without a temporary
+ *  item:
+ *
+ *      template <>
+ *      struct LookupTraits<Employee> : KeyLookup<std::string> {
+ *          static const std::string& keyOf(const Employee& employee) {
+ *              return employee.name;
+ *          }
+ *      };
+ *
+ *      tree.contains("Ada");   // compares names only
+ *
+ *  hash must give equal keys equal hashes, whatever key type they
+ *  arrive as, since the membership filter stores the hashes of the
+ *  item keys and probes with the hash of the key searched for. A key
+ *  type without a hash still works for lookups, by equal alone; only
+ *  the membership filter and the adaptive layout need the hash.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef LOOKUP_TRAITS_
+#define LOOKUP_TRAITS_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/** @class KeyLookup LookupTraits.h "LookupTraits.h"
+ *
+ *  Equality and hash for keys of type KeyType. equal accepts any type
+ *  KeyType compares with; hash converts its argument to KeyType. */
+template <typename KeyType>
+struct KeyLookup {
+    using key_type = KeyType;
+
+    template <typename OtherKey>
+    static auto equal(const KeyType& key, const OtherKey& other) -> decltype(key == other) {
+        return key == other;
+    }
+
+    // Only declared for key types std::hash accepts, so that
+    // HasKeyHash can tell.
+    template <typename HashedKey = KeyType>
+    static auto hash(const KeyType& key) -> decltype(std::hash<HashedKey>()(key) ) {
+        return std::hash<HashedKey>()(key);
+    }
+};
+
+/** String keys are compared and hashed as string views, so that
+ *  std::string, std::string_view and C strings can all be looked up
+ *  without allocating. std::hash gives a string and its view the same
+ *  hash. */
+template <>
+struct KeyLookup<std::string> {
+    using key_type = std::string;
+
+    static bool equal(const std::string& key, std::string_view other) {
+        return std::string_view(key) == other;
+    }
+
+    static std::size_t hash(std::string_view key) {
+        return std::hash<std::string_view>()(key);
+    }
+};
+
+/** @class IdentityLookup LookupTraits.h "LookupTraits.h"
+ *
+ *  The default lookup: the key of an item is the item itself. */
+template <typename ItemType>
+struct IdentityLookup : KeyLookup<ItemType> {
+    static const ItemType& keyOf(const ItemType& item) {
+        return item;
+    }
+};
+
+/** @class LookupTraits LookupTraits.h "LookupTraits.h"
+ *
+ *  Selects how items of ItemType are looked up. A specialization
+ *  provides key_type, keyOf(item), equal(key, other) and hash(key),
+ *  usually by deriving from KeyLookup. */
+template <typename ItemType>
+struct LookupTraits : IdentityLookup<ItemType> {};
+
+/** True if a KeyType searched for in a tree of ItemType can be
+ *  hashed. If not, the membership filter cannot rule it out and the
+ *  lookup walks the tree. */
+template <typename ItemType, typename KeyType, typename = void>
+struct CanHashKey : std::false_type {};
+
+template <typename ItemType, typename KeyType>
+struct CanHashKey<ItemType, KeyType, std::void_t<
+    decltype(LookupTraits<ItemType>::hash(std::declval<const KeyType&>() ) )>>
+: std::true_type {};
+
+/** True if the keys of ItemType can be hashed. Without a hash, the
+ *  structures that index items by key fall back to scanning, and the
+ *  membership filter and adaptive layout are unavailable. */
+template <typename ItemType, typename = void>
+struct HasKeyHash : std::false_type {};
+
+template <typename ItemType>
+struct HasKeyHash<ItemType, std::void_t<
+    decltype(LookupTraits<ItemType>::hash(
+        LookupTraits<ItemType>::keyOf(std::declval<const ItemType&>() ) ) )>>
+: std::true_type {};
+
+/** True if a KeyType can be searched for directly, which only needs
+ *  equal; a hash is used when there is one. Arithmetic keys of
+ *  arithmetic items are excluded, so that they keep converting to
+ *  ItemType first, as they did before heterogeneous lookup. */
+template <typename ItemType, typename KeyType, typename = void>
+struct IsLookupKey : std::false_type {};
+
+template <typename ItemType, typename KeyType>
+struct IsLookupKey<ItemType, KeyType, std::void_t<
+    decltype(LookupTraits<ItemType>::equal(
+        LookupTraits<ItemType>::keyOf(std::declval<const ItemType&>() ),
+        std::declval<const KeyType&>() ) )>>
+: std::integral_constant<bool,
+      !std::is_same<typename std::decay<KeyType>::type, ItemType>::value &&
+      !(std::is_arithmetic<KeyType>::value &&
+        std::is_arithmetic<typename LookupTraits<ItemType>::key_type>::value)> {};
+
+#endif
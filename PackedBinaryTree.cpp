@@ -0,0 +1,253 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for an array-based binary tree of small,
+ *  trivially copyable items.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <algorithm>
+#include <string>
+
+#include "PrecondViolatedExcep.h"
+#include "NotFoundException.h"
+
+//////////////////////////////////////////////////////////////
+//      Protected Utility Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::preorder(void visit(ItemType&),
+                                          std::size_t index) {
+
+    if (index < items.size() ) {
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        visit(items[index]);
+
+        preorder(visit, 2 * index + 1);
+        preorder(visit, 2 * index + 2);
+    }
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::inorder(void visit(ItemType&),
+                                         std::size_t index) {
+
+    if (index < items.size() ) {
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        inorder(visit, 2 * index + 1);
+        visit(items[index]);
+        inorder(visit, 2 * index + 2);
+    }
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::postorder(void visit(ItemType&),
+                                           std::size_t index) {
+
+    if (index < items.size() ) {
+        TreeStatsRecorder::DepthScope depthScope(statsRecorder);
+        statsRecorder.nodeVisited();
+        postorder(visit, 2 * index + 1);
+        postorder(visit, 2 * index + 2);
+        visit(items[index]);
+    }
+}
+
+template <typename ItemType>
+std::size_t PackedBinaryTree<ItemType>::findIndex(const ItemType& anEntry) const {
+
+    statsRecorder.nodeVisited();
+    return static_cast<std::size_t>(std::find(items.begin(), items.end(), anEntry) -
+                                    items.begin() );
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+PackedBinaryTree<ItemType>::PackedBinaryTree(const ItemType& rootItem)
+: items(1, rootItem) {
+
+    statsRecorder.allocated();
+}
+
+//////////////////////////////////////////////////////////////
+//      Public BinaryTreeInterface Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool PackedBinaryTree<ItemType>::isEmpty() const {
+
+    return items.empty();
+}
+
+template <typename ItemType>
+int PackedBinaryTree<ItemType>::getHeight() const {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Height);
+    int height(0);
+    for (std::size_t count(items.size() ); count > 0; count /= 2) {
+        ++height;
+    }
+    return height;
+}
+
+template <typename ItemType>
+int PackedBinaryTree<ItemType>::getNumberOfNodes() const {
+
+    return static_cast<int>(items.size() );
+}
+
+template <typename ItemType>
+ItemType PackedBinaryTree<ItemType>::getRootData() const {
+
+    if (isEmpty() ) {
+        std::string message("PackedBinaryTree::getRootData: called ");
+        message += "on an empty tree.";
+
+        throw PrecondViolatedExcep(message);
+    }
+
+    return items.front();
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::setRootData(const ItemType& newItem) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Other);
+    if (isEmpty() ) {
+        items.push_back(newItem);
+    }
+    else {
+        items.front() = newItem;
+    }
+}
+
+template <typename ItemType>
+bool PackedBinaryTree<ItemType>::add(const ItemType& newData) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Add);
+    if (items.size() == items.capacity() ) {
+        statsRecorder.allocated();
+    }
+    items.push_back(newData);
+
+    return true;
+}
+
+template <typename ItemType>
+bool PackedBinaryTree<ItemType>::remove(const ItemType& target) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Remove);
+    auto index(findIndex(target) );
+    if (index == items.size() ) {
+        return false;
+    }
+
+    // The last slot in level order is always a leaf, so moving its
+    // item up keeps the tree complete.
+    items[index] = items.back();
+    items.pop_back();
+
+    return true;
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::clear() {
+
+    items.clear();
+}
+
+template <typename ItemType>
+ItemType PackedBinaryTree<ItemType>::getEntry(const ItemType& anEntry) const {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::GetEntry);
+    auto index(findIndex(anEntry) );
+
+    if (index == items.size() ) {
+        std::string message("PackedBinaryTree::getEntry: Entry ");
+        message += "not found in this tree.";
+        throw NotFoundException(message);
+    }
+    return items[index];
+}
+
+template <typename ItemType>
+bool PackedBinaryTree<ItemType>::contains(const ItemType& anEntry) const {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Contains);
+    statsRecorder.nodeVisited();
+    return simdContains(items.data(), items.size(), anEntry);
+}
+
+//////////////////////////////////////////////////////////////
+//      Public Traversals Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::preorderTraverse(void visit(ItemType&) ) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    preorder(visit, 0);
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::inorderTraverse(void visit(ItemType&) ) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    inorder(visit, 0);
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::postorderTraverse(void visit(ItemType&) ) {
+
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    postorder(visit, 0);
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::levelorderTraverse(void visit(ItemType&) ) {
+
+    // Level order is storage order.
+    TreeStatsRecorder::OpScope opScope(statsRecorder, TreeOp::Traverse);
+    for (auto& item : items) {
+        statsRecorder.nodeVisited();
+        visit(item);
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Memory Report and Instrumentation
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+double PackedBinaryTree<ItemType>::bytesPerItem() const {
+
+    if (isEmpty() ) {
+        return 0.0;
+    }
+    return static_cast<double>(sizeof(*this) + items.capacity() * sizeof(ItemType) ) /
+           static_cast<double>(items.size() );
+}
+
+template <typename ItemType>
+TreeStats PackedBinaryTree<ItemType>::stats() const {
+
+    return statsRecorder.snapshot();
+}
+
+template <typename ItemType>
+void PackedBinaryTree<ItemType>::resetStats() {
+
+    statsRecorder.reset();
+}
@@ -0,0 +1,168 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for an array-based binary tree of small, trivially
+ *  copyable items.
+ *
+ *  The tree is kept complete and stored in level order in one
+ *  cache-line-aligned array: the children of the item at index i are
+ *  at 2i + 1 and 2i + 2, so no node carries pointers. Each cache line
+ *  holds itemsPerLine consecutive items (16 ints), which plays the
+ *  part of a multi-item node. An unordered search is a linear scan,
+ *  so contains compares a whole line per SIMD step.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef PACKED_BINARY_TREE_
+#define PACKED_BINARY_TREE_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "BinaryNodeTree.h"
+#include "BinaryTreeInterface.h"
+#include "SimdKernels.h"
+#include "TreeStats.h"
+
+/** Size of the blocks PackedBinaryTree aligns its storage to. */
+constexpr std::size_t cacheLineSize = 64;
+
+/** @class CacheLineAllocator PackedBinaryTree.h "PackedBinaryTree.h"
+ *
+ *  Allocator whose blocks start on a cache-line boundary. */
+template <typename ItemType>
+struct CacheLineAllocator {
+    using value_type = ItemType;
+
+    CacheLineAllocator() = default;
+    template <typename OtherType>
+    CacheLineAllocator(const CacheLineAllocator<OtherType>&) {}
+
+    ItemType* allocate(std::size_t count) {
+        return static_cast<ItemType*>(::operator new(count * sizeof(ItemType),
+                                                     std::align_val_t(cacheLineSize) ) );
+    }
+    void deallocate(ItemType* block, std::size_t) {
+        ::operator delete(block, std::align_val_t(cacheLineSize) );
+    }
+
+    template <typename OtherType>
+    bool operator==(const CacheLineAllocator<OtherType>&) const { return true; }
+    template <typename OtherType>
+    bool operator!=(const CacheLineAllocator<OtherType>&) const { return false; }
+};
+
+/** @class PackedBinaryTree PackedBinaryTree.h "PackedBinaryTree.h"
+ *
+ *  Specification of an implicit, array-based ADT binary tree.
+ *
+ *  add fills the next free slot in level order; remove moves the last
+ *  item into the removed slot. Both keep the tree complete, so the
+ *  height is always floor(log2 n) + 1. */
+template <typename ItemType>
+class PackedBinaryTree : public BinaryTreeInterface<ItemType> {
+    static_assert(std::is_trivially_copyable<ItemType>::value,
+                  "PackedBinaryTree stores items by value in a flat array.");
+
+public:
+    /** Number of items that share one cache line. */
+    static constexpr std::size_t itemsPerLine =
+        sizeof(ItemType) < cacheLineSize ? cacheLineSize / sizeof(ItemType) : 1;
+
+private:
+    std::vector<ItemType, CacheLineAllocator<ItemType>> items;
+
+    // Hot-path counters; compiled away unless BINARY_TREE_STATS is
+    // defined (see TreeStats.h).
+    mutable TreeStatsRecorder statsRecorder;
+
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Recursive helper methods for the public methods. The recursion
+    // depth is the height, which is logarithmic here.
+    //------------------------------------------------------------
+    void preorder(void visit(ItemType&), std::size_t index);
+    void inorder(void visit(ItemType&), std::size_t index);
+    void postorder(void visit(ItemType&), std::size_t index);
+
+    // Index of the first item equal to anEntry in level order, or
+    // the number of items if there is none.
+    std::size_t findIndex(const ItemType& anEntry) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    PackedBinaryTree() = default;
+    PackedBinaryTree(const ItemType& rootItem);
+
+    virtual ~PackedBinaryTree() = default;
+
+    //------------------------------------------------------------
+    // Public BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    bool isEmpty() const override;
+
+    int getHeight() const override;
+
+    int getNumberOfNodes() const override;
+
+    ItemType getRootData() const override;
+
+    void setRootData(const ItemType& newData) override;
+
+    bool add(const ItemType& newData) override;
+
+    bool remove(const ItemType& data) override;
+
+    void clear() override;
+
+    ItemType getEntry(const ItemType& anEntry) const override;
+
+    bool contains(const ItemType& anEntry) const override;
+
+    //------------------------------------------------------------
+    // Public Traversals Section.
+    //------------------------------------------------------------
+    void preorderTraverse(void visit(ItemType&) ) override;
+    void inorderTraverse(void visit(ItemType&) ) override;
+    void postorderTraverse(void visit(ItemType&) ) override;
+    void levelorderTraverse(void visit(ItemType&) ) override;
+
+    //------------------------------------------------------------
+    // Memory report: bytes of storage per item, counting the tree
+    // object and the unused capacity of the array.
+    //------------------------------------------------------------
+    double bytesPerItem() const;
+
+    //------------------------------------------------------------
+    // Instrumentation counters (all zero unless BINARY_TREE_STATS).
+    // With BINARY_TREE_STATS_LATENCY the Contains and GetEntry
+    // histograms give the lookup latency.
+    //------------------------------------------------------------
+    TreeStats stats() const;
+    void resetStats();
+};
+
+/** The binary tree best suited to ItemType: PackedBinaryTree for
+ *  trivially copyable items of at most 8 bytes, whose per-node
+ *  pointers would otherwise outweigh the item, and BinaryNodeTree for
+ *  everything else. */
+template <typename ItemType>
+using CompactBinaryTree =
+    typename std::conditional<std::is_trivially_copyable<ItemType>::value &&
+                              sizeof(ItemType) <= 8,
+                              PackedBinaryTree<ItemType>,
+                              BinaryNodeTree<ItemType>>::type;
+
+#include "PackedBinaryTree.cpp"
+
+#endif
@@ -0,0 +1,646 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for a binary tree whose nodes live on disk.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "PrecondViolatedExcep.h"
+#include "NotFoundException.h"
+#include "RingQueue.h"
+#include "ScratchBuffer.h"
+
+//////////////////////////////////////////////////////////////
+//      Protected Buffer Pool Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::ioError(const char* what) const {
+
+    std::string message("PagedBinaryTree: cannot ");
+    message += what;
+    message += " ";
+    message += path;
+    message += ".";
+    throw std::runtime_error(message);
+}
+
+template <typename ItemType>
+std::size_t PagedBinaryTree<ItemType>::frameFor(std::uint64_t page, bool fresh) {
+
+    auto found(frameOf.find(page) );
+    if (found != frameOf.end() ) {
+        ++ioStats.hits;
+        if (found->second != newest) {
+            unlinkFrame(found->second);
+            linkNewest(found->second);
+        }
+        return found->second;
+    }
+
+    ++ioStats.misses;
+    std::size_t frame;
+    if (frames.size() < cachePages) {
+        frame = frames.size();
+        frames.emplace_back();
+        frames.back().bytes.resize(pageSize);
+    }
+    else {
+        frame = oldest;
+        unlinkFrame(frame);
+        if (frames[frame].dirty) {
+            writeBack(frames[frame]);
+        }
+        frameOf.erase(frames[frame].page);
+    }
+
+    auto& bytes(frames[frame].bytes);
+    frames[frame].page = page;
+    frames[frame].dirty = fresh;
+    if (fresh) {
+        std::fill(bytes.begin(), bytes.end(), 0);
+    }
+    else {
+        const auto offset(static_cast<off_t>(page * pageSize) );
+        if (::pread(file, bytes.data(), pageSize, offset) != static_cast<ssize_t>(pageSize) ) {
+            // Leave the frame empty rather than holding a bad page.
+            frames[frame].page = npos;
+            linkNewest(frame);
+            ioError("read a page of");
+        }
+        ++ioStats.pageReads;
+    }
+    frameOf.emplace(page, frame);
+    linkNewest(frame);
+    return frame;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::unlinkFrame(std::size_t frame) {
+
+    auto& entry(frames[frame]);
+    (entry.newer == noFrame ? newest : frames[entry.newer].older) = entry.older;
+    (entry.older == noFrame ? oldest : frames[entry.older].newer) = entry.newer;
+    entry.newer = entry.older = noFrame;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::linkNewest(std::size_t frame) {
+
+    frames[frame].older = newest;
+    frames[frame].newer = noFrame;
+    (newest == noFrame ? oldest : frames[newest].newer) = frame;
+    newest = frame;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::writeBack(Frame& frame) {
+
+    const auto offset(static_cast<off_t>(frame.page * pageSize) );
+    if (::pwrite(file, frame.bytes.data(), pageSize, offset) != static_cast<ssize_t>(pageSize) ) {
+        ioError("write a page of");
+    }
+    ++ioStats.pageWrites;
+    frame.dirty = false;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::writeHeader() {
+
+    std::vector<unsigned char> header(pageSize, 0);
+    const std::uint32_t sizes[2] = {static_cast<std::uint32_t>(pageSize),
+                                    static_cast<std::uint32_t>(sizeof(Node) )};
+    const std::uint64_t counts[3] = {root, nodeCount, pageCount};
+    std::memcpy(header.data(), fileMagic, 4);
+    std::memcpy(header.data() + 4, sizes, sizeof(sizes) );
+    std::memcpy(header.data() + 16, counts, sizeof(counts) );
+    if (::pwrite(file, header.data(), pageSize, 0) != static_cast<ssize_t>(pageSize) ) {
+        ioError("write the header of");
+    }
+    ++ioStats.pageWrites;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::readHeader() {
+
+    unsigned char header[40];
+    if (::pread(file, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header) ) ) {
+        ioError("read the header of");
+    }
+    std::uint32_t sizes[2];
+    std::uint64_t counts[3];
+    std::memcpy(sizes, header + 4, sizeof(sizes) );
+    std::memcpy(counts, header + 16, sizeof(counts) );
+    if (std::memcmp(header, fileMagic, 4) != 0 || sizes[1] != sizeof(Node) ) {
+        ioError("recognize the layout of");
+    }
+    ++ioStats.pageReads;
+    pageSize = sizes[0];
+    root = counts[0];
+    nodeCount = counts[1];
+    pageCount = counts[2];
+}
+
+//////////////////////////////////////////////////////////////
+//      Protected Node Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+typename PagedBinaryTree<ItemType>::Node PagedBinaryTree<ItemType>::readNode(std::uint64_t id) {
+
+    // An id past the used slots can only come from a damaged file;
+    // following it would read the header or zeros as a node.
+    const auto page(id / slotsPerPage);
+    if (page == 0 || page >= pageCount) {
+        ioError("follow a node id in");
+    }
+    const auto& frame(frames[frameFor(page)]);
+    std::uint32_t used(0);
+    std::memcpy(&used, frame.bytes.data(), sizeof(used) );
+    if (id % slotsPerPage >= used) {
+        ioError("follow a node id in");
+    }
+    Node node;
+    std::memcpy(&node, frame.bytes.data() + pageHeaderSize + (id % slotsPerPage) * sizeof(Node),
+                sizeof(Node) );
+    return node;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::writeNode(std::uint64_t id, const Node& node) {
+
+    auto& frame(frames[frameFor(id / slotsPerPage)]);
+    std::memcpy(frame.bytes.data() + pageHeaderSize + (id % slotsPerPage) * sizeof(Node),
+                &node, sizeof(Node) );
+    frame.dirty = true;
+}
+
+template <typename ItemType>
+std::uint64_t PagedBinaryTree<ItemType>::allocateNode(const Node& node, std::uint64_t near) {
+
+    std::uint64_t page(near == npos ? npos : near / slotsPerPage);
+    std::uint32_t used(0);
+    if (page != npos) {
+        std::memcpy(&used, frames[frameFor(page)].bytes.data(), sizeof(used) );
+    }
+    if (page == npos || used == slotsPerPage) {
+        page = pageCount++;
+        frameFor(page, true);
+        used = 0;
+    }
+
+    auto& frame(frames[frameFor(page)]);
+    const std::uint32_t nowUsed(used + 1);
+    std::memcpy(frame.bytes.data(), &nowUsed, sizeof(nowUsed) );
+    frame.dirty = true;
+    const auto id(page * slotsPerPage + used);
+    writeNode(id, node);
+    ++nodeCount;
+    return id;
+}
+
+template <typename ItemType>
+std::uint64_t PagedBinaryTree<ItemType>::findNode(const ItemType& anEntry) {
+
+    ScratchBuffer<std::vector<std::uint64_t>> scratch;
+    auto& pending(scratch.get() );
+    if (root != npos) {
+        pending.push_back(root);
+    }
+    while (!pending.empty() ) {
+        auto id(pending.back() );
+        pending.pop_back();
+        auto node(readNode(id) );
+        if (node.item == anEntry) {
+            return id;
+        }
+        if (node.right != npos) {
+            pending.push_back(node.right);
+        }
+        if (node.left != npos) {
+            pending.push_back(node.left);
+        }
+    }
+    return npos;
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor and Destructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+PagedBinaryTree<ItemType>::PagedBinaryTree(const std::string& path,
+                                           std::size_t cachePages,
+                                           std::size_t pageSize)
+: path(path),
+  pageSize(pageSize),
+  cachePages(cachePages) {
+
+    if (cachePages == 0) {
+        std::string message("PagedBinaryTree: cachePages ");
+        message += "must be positive.";
+        throw PrecondViolatedExcep(message);
+    }
+    file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        ioError("open");
+    }
+
+    try {
+        struct stat status;
+        if (::fstat(file, &status) != 0) {
+            ioError("stat");
+        }
+        if (status.st_size > 0) {
+            readHeader();
+        }
+        slotsPerPage = this->pageSize > pageHeaderSize ?
+                       (this->pageSize - pageHeaderSize) / sizeof(Node) : 0;
+        if (slotsPerPage == 0) {
+            std::string message("PagedBinaryTree: a page of ");
+            message += std::to_string(this->pageSize);
+            message += " bytes cannot hold a node.";
+            throw PrecondViolatedExcep(message);
+        }
+        if (status.st_size == 0) {
+            writeHeader();
+        }
+    }
+    catch (...) {
+        ::close(file);
+        throw;
+    }
+    frames.reserve(cachePages);
+}
+
+template <typename ItemType>
+PagedBinaryTree<ItemType>::~PagedBinaryTree() {
+
+    try {
+        flush();
+    }
+    catch (const std::runtime_error&) {
+        // Destructors must not throw; the unwritten pages are lost.
+    }
+    ::close(file);
+}
+
+//////////////////////////////////////////////////////////////
+//      Public Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool PagedBinaryTree<ItemType>::isEmpty() const {
+
+    return root == npos;
+}
+
+template <typename ItemType>
+int PagedBinaryTree<ItemType>::getHeight() {
+
+    if (isEmpty() ) {
+        return 0;
+    }
+    auto node(readNode(root) );
+    return 1 + static_cast<int>(std::max(node.leftHeight, node.rightHeight) );
+}
+
+template <typename ItemType>
+int PagedBinaryTree<ItemType>::getNumberOfNodes() const {
+
+    return static_cast<int>(nodeCount);
+}
+
+template <typename ItemType>
+ItemType PagedBinaryTree<ItemType>::getRootData() {
+
+    if (isEmpty() ) {
+        std::string message("PagedBinaryTree::getRootData: called ");
+        message += "on an empty tree.";
+
+        throw PrecondViolatedExcep(message);
+    }
+    return readNode(root).item;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::setRootData(const ItemType& newData) {
+
+    if (isEmpty() ) {
+        add(newData);
+        return;
+    }
+    auto node(readNode(root) );
+    node.item = newData;
+    writeNode(root, node);
+}
+
+template <typename ItemType>
+bool PagedBinaryTree<ItemType>::add(const ItemType& newData) {
+
+    const Node leaf{newData, 0, 0, npos, npos};
+    if (isEmpty() ) {
+        root = allocateNode(leaf, npos);
+        return true;
+    }
+
+    // Go down the shorter side, as BinaryNodeTree::balancedAdd does,
+    // remembering the path and the turn taken at each node.
+    ScratchBuffer<std::vector<std::pair<std::uint64_t, bool>>> scratch;
+    auto& path(scratch.get() );
+    for (auto id(root); id != npos; ) {
+        auto node(readNode(id) );
+        const bool right(node.leftHeight > node.rightHeight);
+        path.emplace_back(id, right);
+        id = right ? node.right : node.left;
+    }
+
+    // Link the new leaf, then raise the heights above it until one
+    // stops changing.
+    auto child(allocateNode(leaf, path.back().first) );
+    std::uint32_t childHeight(1);
+    for (auto step(path.rbegin() ); step != path.rend(); ++step) {
+        auto node(readNode(step->first) );
+        const auto oldHeight(std::max(node.leftHeight, node.rightHeight) );
+        if (step->second) {
+            node.rightHeight = childHeight;
+        }
+        else {
+            node.leftHeight = childHeight;
+        }
+        if (child != npos) {
+            (step->second ? node.right : node.left) = child;
+            child = npos;
+        }
+        writeNode(step->first, node);
+        childHeight = 1 + std::max(node.leftHeight, node.rightHeight);
+        if (childHeight == 1 + oldHeight) {
+            break;
+        }
+    }
+    return true;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::clear() {
+
+    frames.clear();
+    frameOf.clear();
+    newest = oldest = noFrame;
+    root = npos;
+    nodeCount = 0;
+    pageCount = 1;
+    if (::ftruncate(file, static_cast<off_t>(pageSize) ) != 0) {
+        ioError("truncate");
+    }
+    writeHeader();
+}
+
+template <typename ItemType>
+ItemType PagedBinaryTree<ItemType>::getEntry(const ItemType& anEntry) {
+
+    auto id(findNode(anEntry) );
+
+    if (id == npos) {
+        std::string message("PagedBinaryTree::getEntry: Entry ");
+        message += "not found in this tree.";
+        throw NotFoundException(message);
+    }
+    return readNode(id).item;
+}
+
+template <typename ItemType>
+bool PagedBinaryTree<ItemType>::contains(const ItemType& anEntry) {
+
+    return findNode(anEntry) != npos;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::load(const BinaryNodeTree<ItemType>& tree) {
+
+    using NodeView = typename BinaryNodeTree<ItemType>::NodeView;
+    clear();
+    if (tree.isEmpty() ) {
+        return;
+    }
+
+    // Subtree heights and sizes of the source, from one postorder
+    // pass. Flips change neither, so the nodes themselves are the keys.
+    struct Extent {
+        std::uint32_t height;
+        std::uint64_t size;
+    };
+    std::unordered_map<const void*, Extent> extents;
+    auto extentOf = [&extents](const NodeView& node) {
+        return node ? extents[node.get()] : Extent{0, 0};
+    };
+    {
+        ScratchBuffer<std::vector<std::pair<NodeView, bool>>> scratch;
+        auto& pending(scratch.get() );
+        pending.emplace_back(tree.rootView(), false);
+        while (!pending.empty() ) {
+            auto entry(pending.back() );
+            pending.pop_back();
+            if (entry.second) {
+                const auto left(extentOf(entry.first.left() ) );
+                const auto right(extentOf(entry.first.right() ) );
+                extents[entry.first.get()] = {1 + std::max(left.height, right.height),
+                                              1 + left.size + right.size};
+                continue;
+            }
+            pending.emplace_back(entry.first, true);
+            for (auto child : {entry.first.right(), entry.first.left()}) {
+                if (child) {
+                    pending.emplace_back(child, false);
+                }
+            }
+        }
+    }
+
+    // A cluster takes up to slotsPerPage nodes from its root in level
+    // order, and the nodes left over start clusters of their own. A
+    // cluster goes on the last page written if it fits there, so small
+    // subtrees near the leaves share pages; otherwise it starts a new
+    // page. A node is linked into its parent once its id is known.
+    struct Placement {
+        NodeView node;
+        std::uint64_t parent;
+        bool right;
+    };
+    RingQueue<Placement> clusters;
+    std::vector<Placement> level;
+    std::uint64_t lastId(npos);
+    std::uint64_t lastPageFree(0);
+    clusters.enqueue({tree.rootView(), npos, false});
+    while (!clusters.isEmpty() ) {
+        level.assign(1, clusters.peekFront() );
+        clusters.dequeue();
+
+        const auto clusterSize(std::min<std::uint64_t>(extentOf(level.front().node).size,
+                                                       slotsPerPage) );
+        std::uint64_t near(clusterSize <= lastPageFree ? lastId : npos);
+        std::size_t next(0);
+        for (; next < level.size() && next < clusterSize; ++next) {
+            const auto placement(level[next]);
+            const NodeView& node(placement.node);
+            const Node stored{node.item(), extentOf(node.left() ).height,
+                              extentOf(node.right() ).height, npos, npos};
+            near = allocateNode(stored, near);
+            if (placement.parent == npos) {
+                root = near;
+            }
+            else {
+                auto parent(readNode(placement.parent) );
+                (placement.right ? parent.right : parent.left) = near;
+                writeNode(placement.parent, parent);
+            }
+            if (node.left() ) {
+                level.push_back({node.left(), near, false});
+            }
+            if (node.right() ) {
+                level.push_back({node.right(), near, true});
+            }
+        }
+        for (; next < level.size(); ++next) {
+            clusters.enqueue(level[next]);
+        }
+        lastId = near;
+        lastPageFree = slotsPerPage - 1 - near % slotsPerPage;
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Traversals Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+template <typename Visitor>
+void PagedBinaryTree<ItemType>::preorderTraverse(Visitor visit) {
+
+    ScratchBuffer<std::vector<std::uint64_t>> scratch;
+    auto& pending(scratch.get() );
+    if (root != npos) {
+        pending.push_back(root);
+    }
+    while (!pending.empty() ) {
+        auto node(readNode(pending.back() ) );
+        pending.pop_back();
+        visit(node.item);
+        if (node.right != npos) {
+            pending.push_back(node.right);
+        }
+        if (node.left != npos) {
+            pending.push_back(node.left);
+        }
+    }
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void PagedBinaryTree<ItemType>::inorderTraverse(Visitor visit) {
+
+    ScratchBuffer<std::vector<std::uint64_t>> scratch;
+    auto& pending(scratch.get() );
+    auto id(root);
+    while (id != npos || !pending.empty() ) {
+        while (id != npos) {
+            pending.push_back(id);
+            id = readNode(id).left;
+        }
+        auto node(readNode(pending.back() ) );
+        pending.pop_back();
+        visit(node.item);
+        id = node.right;
+    }
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void PagedBinaryTree<ItemType>::postorderTraverse(Visitor visit) {
+
+    // A node is pushed twice: first to expand it, then, below its
+    // children, to visit it.
+    ScratchBuffer<std::vector<std::pair<std::uint64_t, bool>>> scratch;
+    auto& pending(scratch.get() );
+    if (root != npos) {
+        pending.emplace_back(root, false);
+    }
+    while (!pending.empty() ) {
+        auto entry(pending.back() );
+        pending.pop_back();
+        auto node(readNode(entry.first) );
+        if (entry.second) {
+            visit(node.item);
+            continue;
+        }
+        pending.emplace_back(entry.first, true);
+        if (node.right != npos) {
+            pending.emplace_back(node.right, false);
+        }
+        if (node.left != npos) {
+            pending.emplace_back(node.left, false);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Storage Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::flush() {
+
+    for (auto& frame : frames) {
+        if (frame.dirty) {
+            writeBack(frame);
+        }
+    }
+    writeHeader();
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::dropCache() {
+
+    flush();
+    frames.clear();
+    frameOf.clear();
+    newest = oldest = noFrame;
+}
+
+template <typename ItemType>
+std::size_t PagedBinaryTree<ItemType>::getSlotsPerPage() const {
+
+    return slotsPerPage;
+}
+
+template <typename ItemType>
+std::uint64_t PagedBinaryTree<ItemType>::getPageCount() const {
+
+    return pageCount;
+}
+
+template <typename ItemType>
+PageIoStats PagedBinaryTree<ItemType>::getIoStats() const {
+
+    return ioStats;
+}
+
+template <typename ItemType>
+void PagedBinaryTree<ItemType>::resetIoStats() {
+
+    ioStats = PageIoStats();
+}
@@ -0,0 +1,206 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a binary tree whose nodes live on disk, for trees
+ *  larger than memory.
+ *
+ *  The nodes are stored in fixed-size pages of one file, and a node is
+ *  named by its page and slot. Only a bounded pool of pages is held in
+ *  memory. On a miss the least recently used page is written back if
+ *  it is dirty and then reused. Nodes are clustered by subtree. A new
+ *  node goes on its parent's page while that page has room. Otherwise
+ *  it starts a fresh page, which its own descendants then fill.
+ *  Loading a BinaryNodeTree fills each page with the top levels of one
+ *  subtree. A walk down the tree therefore reads about one page per
+ *  slotsPerPage levels it covers, not one per node.
+ *
+ *  Page 0 is a header with the root, the number of nodes and the
+ *  number of pages, so the file can be reopened later. The header and
+ *  dirty pages reach the file on flush() and on destruction.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef PAGED_BINARY_TREE_
+#define PAGED_BINARY_TREE_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "BinaryNodeTree.h"
+
+/** @class PageIoStats PagedBinaryTree.h "PagedBinaryTree.h"
+ *
+ *  Buffer pool counters. A hit finds the page in memory; a miss reads
+ *  it from the file, unless the page is new. A write is a dirty page
+ *  written back on eviction or flush. */
+struct PageIoStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t pageReads = 0;
+    std::uint64_t pageWrites = 0;
+};
+
+/** @class PagedBinaryTree PagedBinaryTree.h "PagedBinaryTree.h"
+ *
+ *  Disk-backed binary tree. add places items the way BinaryNodeTree
+ *  does, in the shorter subtree, so both build the same shape from
+ *  the same items. Each node stores the heights of its subtrees, so
+ *  an add only reads the pages on one root-to-leaf path. The items
+ *  are written as raw bytes, so ItemType must be trivially copyable.
+ *  I/O failures throw std::runtime_error. */
+template <typename ItemType>
+class PagedBinaryTree {
+    static_assert(std::is_trivially_copyable<ItemType>::value,
+                  "PagedBinaryTree writes items as raw bytes.");
+
+public:
+    /** Node id meaning "no node". */
+    static constexpr std::uint64_t npos = ~std::uint64_t(0);
+
+private:
+    // On-disk node; copied in and out of pages with memcpy. Keeping
+    // both child heights lets add choose a side without reading the
+    // children.
+    struct Node {
+        ItemType item;
+        std::uint32_t leftHeight;
+        std::uint32_t rightHeight;
+        std::uint64_t left;
+        std::uint64_t right;
+    };
+
+    // File layout (integers as stored in memory):
+    //   page 0:      magic, u32 page size, u32 node size, padding to
+    //                16 bytes, u64 root, u64 nodes, u64 pages
+    //   other pages: u32 slots used, padding to 8 bytes, nodes
+    static constexpr char fileMagic[5] = "BTP1";
+    static constexpr std::size_t pageHeaderSize = 8;
+
+    // One cached page. The frames form an LRU list, newest at head.
+    struct Frame {
+        std::uint64_t page = npos;
+        bool dirty = false;
+        std::size_t newer = noFrame;
+        std::size_t older = noFrame;
+        std::vector<unsigned char> bytes;
+    };
+    static constexpr std::size_t noFrame = ~std::size_t(0);
+
+    std::string path;
+    int file = -1;
+    std::size_t pageSize;
+    std::size_t slotsPerPage = 0;
+    std::size_t cachePages;
+
+    std::uint64_t root = npos;
+    std::uint64_t nodeCount = 0;
+    std::uint64_t pageCount = 1;
+
+    std::vector<Frame> frames;
+    std::unordered_map<std::uint64_t, std::size_t> frameOf;
+    std::size_t newest = noFrame;
+    std::size_t oldest = noFrame;
+
+    mutable PageIoStats ioStats;
+
+protected:
+    //------------------------------------------------------------
+    // Buffer pool. frameFor returns the frame holding page, reading
+    // it in if needed; fresh pages start zeroed and are not read.
+    //------------------------------------------------------------
+    [[noreturn]] void ioError(const char* what) const;
+    std::size_t frameFor(std::uint64_t page, bool fresh = false);
+    void unlinkFrame(std::size_t frame);
+    void linkNewest(std::size_t frame);
+    void writeBack(Frame& frame);
+    void writeHeader();
+    void readHeader();
+
+    //------------------------------------------------------------
+    // Nodes. The node accessors copy, so that a later eviction
+    // cannot invalidate what the caller holds.
+    //------------------------------------------------------------
+    Node readNode(std::uint64_t id);
+    void writeNode(std::uint64_t id, const Node& node);
+    // Allocates a slot on near's page if it has room, else on a new
+    // page, and writes node there.
+    std::uint64_t allocateNode(const Node& node, std::uint64_t near);
+
+    // Id of the first node in preorder holding anEntry, or npos.
+    std::uint64_t findNode(const ItemType& anEntry);
+
+public:
+    //------------------------------------------------------------
+    // Constructor and Destructor Section.
+    //------------------------------------------------------------
+    // Opens path, or creates it if it does not exist, and caches at
+    // most cachePages pages of pageSize bytes. An existing file
+    // keeps the page size it was created with.
+    // @pre cachePages > 0, and a page holds at least one node.
+    PagedBinaryTree(const std::string& path,
+                    std::size_t cachePages,
+                    std::size_t pageSize = 4096);
+
+    PagedBinaryTree(const PagedBinaryTree&) = delete;
+    PagedBinaryTree& operator=(const PagedBinaryTree&) = delete;
+
+    // Flushes; errors are ignored here.
+    ~PagedBinaryTree();
+
+    //------------------------------------------------------------
+    // Public Methods Section, as in BinaryNodeTree. The mutators and
+    // lookups are not const because they move pages in and out of
+    // the pool.
+    //------------------------------------------------------------
+    bool isEmpty() const;
+    int getHeight();
+    int getNumberOfNodes() const;
+    ItemType getRootData();
+    void setRootData(const ItemType& newData);
+    bool add(const ItemType& newData);
+    // Empties the tree and truncates the file.
+    void clear();
+    ItemType getEntry(const ItemType& anEntry);
+    bool contains(const ItemType& anEntry);
+
+    // Replaces the contents with a copy of tree, one subtree cluster
+    // per page.
+    void load(const BinaryNodeTree<ItemType>& tree);
+
+    //------------------------------------------------------------
+    // Public Traversals Section. Each calls visit(item) with a copy
+    // of every item; the explicit stacks hold node ids only.
+    //------------------------------------------------------------
+    template <typename Visitor>
+    void preorderTraverse(Visitor visit);
+    template <typename Visitor>
+    void inorderTraverse(Visitor visit);
+    template <typename Visitor>
+    void postorderTraverse(Visitor visit);
+
+    //------------------------------------------------------------
+    // Storage Section.
+    //------------------------------------------------------------
+    // Writes the dirty pages and the header to the file.
+    void flush();
+    // Writes back and drops every cached page, so that the next
+    // operations start cold.
+    void dropCache();
+    std::size_t getSlotsPerPage() const;
+    std::uint64_t getPageCount() const;
+    PageIoStats getIoStats() const;
+    void resetIoStats();
+};
+
+#include "PagedBinaryTree.cpp"
+
+#endif
@@ -0,0 +1,72 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for the accumulator used by path-sum queries.
+ *
+ *  Integer items up to 32 bits are summed in long long, which cannot
+ *  overflow for any tree that fits in memory. Wider integer types are
+ *  summed in their own width with overflow checks, and floating-point
+ *  types in their own type.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef PATH_SUM_TRAITS_
+#define PATH_SUM_TRAITS_
+
+#include <stdexcept>
+#include <type_traits>
+
+/** @class PathSumTraits PathSumTraits.h "PathSumTraits.h"
+ *
+ *  Selects the accumulator type for sums of ItemType and adds to it
+ *  without silent overflow. */
+template <typename ItemType>
+struct PathSumTraits {
+    using type = typename std::conditional<std::is_integral<ItemType>::value &&
+                                           sizeof(ItemType) <= 4,
+                                           long long,
+                                           ItemType>::type;
+};
+
+/** Adds two accumulators. constexpr, so that an overflow during
+ *  constant evaluation is a compile error.
+ *
+ *  @throws std::overflow_error If an integer sum does not fit. */
+template <typename Accumulator>
+constexpr Accumulator checkedAdd(const Accumulator& lhs, const Accumulator& rhs) {
+    if constexpr (std::is_integral<Accumulator>::value) {
+        Accumulator result{};
+        if (__builtin_add_overflow(lhs, rhs, &result) ) {
+            throw std::overflow_error("checkedAdd: path sum overflows its accumulator.");
+        }
+        return result;
+    }
+    else {
+        return lhs + rhs;
+    }
+}
+
+/** Subtracts two accumulators.
+ *
+ *  @param difference Receives lhs - rhs.
+ *
+ *  @return False if an integer difference does not fit, in which case
+ *          difference is unspecified. */
+template <typename Accumulator>
+bool trySubtract(const Accumulator& lhs, const Accumulator& rhs, Accumulator& difference) {
+    if constexpr (std::is_integral<Accumulator>::value) {
+        return !__builtin_sub_overflow(lhs, rhs, &difference);
+    }
+    else {
+        difference = lhs - rhs;
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,115 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for an append-only bit vector with rank and select.
+ *
+ *  A directory of 32-bit one-counts, one per 512-bit block, makes
+ *  rank O(1) for about 6% extra space. select binary-searches the
+ *  directory and then scans at most eight words.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef RANK_SELECT_BIT_VECTOR_
+#define RANK_SELECT_BIT_VECTOR_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @class RankSelectBitVector RankSelectBitVector.h "RankSelectBitVector.h"
+ *
+ *  Static bit vector: append every bit, call finalize(), then query. */
+class RankSelectBitVector {
+public:
+    void pushBack(bool bit) {
+        if (bitCount % 64 == 0) {
+            words.push_back(0);
+        }
+        if (bit) {
+            words.back() |= std::uint64_t(1) << (bitCount % 64);
+        }
+        ++bitCount;
+    }
+
+    /** Builds the rank directory; call after the last pushBack. */
+    void finalize() {
+        words.shrink_to_fit();
+        blockRanks.assign( (words.size() + wordsPerBlock - 1) / wordsPerBlock + 1, 0);
+        std::uint32_t ones(0);
+        for (std::size_t word(0); word < words.size(); ++word) {
+            if (word % wordsPerBlock == 0) {
+                blockRanks[word / wordsPerBlock] = ones;
+            }
+            ones += static_cast<std::uint32_t>(__builtin_popcountll(words[word]) );
+        }
+        blockRanks.back() = ones;
+        blockRanks.shrink_to_fit();
+    }
+
+    std::size_t size() const { return bitCount; }
+
+    bool get(std::size_t position) const {
+        return (words[position / 64] >> (position % 64) ) & 1;
+    }
+
+    /** Number of ones in [0, position). */
+    std::size_t rank1(std::size_t position) const {
+        const std::size_t lastWord(position / 64);
+        std::size_t ones(blockRanks[lastWord / wordsPerBlock]);
+        for (std::size_t word(lastWord - lastWord % wordsPerBlock); word < lastWord; ++word) {
+            ones += static_cast<std::size_t>(__builtin_popcountll(words[word]) );
+        }
+        if (position % 64 != 0) {
+            ones += static_cast<std::size_t>(__builtin_popcountll(
+                words[lastWord] & ( (std::uint64_t(1) << (position % 64) ) - 1) ) );
+        }
+        return ones;
+    }
+
+    /** Position of the one with rank k (0-based).
+     *
+     *  @pre k < rank1(size() ). */
+    std::size_t select1(std::size_t k) const {
+        // Last block whose count of preceding ones is <= k.
+        const auto block(std::upper_bound(blockRanks.begin(), blockRanks.end() - 1,
+                                          static_cast<std::uint32_t>(k) ) -
+                         blockRanks.begin() - 1);
+        std::size_t remaining(k - blockRanks[block]);
+        std::size_t word(static_cast<std::size_t>(block) * wordsPerBlock);
+        for (;; ++word) {
+            const auto ones(static_cast<std::size_t>(__builtin_popcountll(words[word]) ) );
+            if (remaining < ones) {
+                break;
+            }
+            remaining -= ones;
+        }
+        std::uint64_t bits(words[word]);
+        for (; remaining > 0; --remaining) {
+            bits &= bits - 1;
+        }
+        return word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits) );
+    }
+
+    std::size_t sizeInBytes() const {
+        return words.capacity() * sizeof(std::uint64_t) +
+               blockRanks.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    static constexpr std::size_t wordsPerBlock = 8;
+
+    std::vector<std::uint64_t> words;
+    // blockRanks[b] is the number of ones before word b * wordsPerBlock;
+    // the extra last entry is the total.
+    std::vector<std::uint32_t> blockRanks;
+    std::size_t bitCount = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a growable ring-buffer queue.
+ *
+ *  The buffer is a power of two in size and is never shrunk by
+ *  clear(), so a queue that is reused across calls stops allocating
+ *  once it has grown to the widest level it has seen.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef RING_QUEUE_
+#define RING_QUEUE_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/** @class RingQueue RingQueue.h "RingQueue.h"
+ *
+ *  FIFO queue over a circular buffer. */
+template <typename ItemType>
+class RingQueue {
+public:
+    bool isEmpty() const { return count == 0; }
+    std::size_t size() const { return count; }
+
+    void enqueue(const ItemType& newEntry) {
+        if (count == buffer.size() ) {
+            grow();
+        }
+        buffer[(head + count) & (buffer.size() - 1)] = newEntry;
+        ++count;
+    }
+
+    /** @pre The queue is not empty. */
+    ItemType& peekFront() { return buffer[head]; }
+
+    /** @pre The queue is not empty. */
+    void dequeue() {
+        head = (head + 1) & (buffer.size() - 1);
+        --count;
+    }
+
+    // Empties the queue but keeps its storage for the next use.
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    void grow() {
+        std::vector<ItemType> larger(buffer.empty() ? 16 : 2 * buffer.size() );
+        for (std::size_t i(0); i < count; ++i) {
+            larger[i] = std::move(buffer[(head + i) & (buffer.size() - 1)]);
+        }
+        buffer.swap(larger);
+        head = 0;
+    }
+
+    std::vector<ItemType> buffer;
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+
+#endif
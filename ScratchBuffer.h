@@ -0,0 +1,64 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for per-thread scratch storage reused across calls.
+ *
+ *  Each thread owns one instance of Container per (Container, Tag)
+ *  pair. A ScratchBuffer borrows it for its lifetime; a nested borrow
+ *  on the same thread (e.g. a traversal started from inside a visit
+ *  callback) gets a private container instead, so the two never
+ *  interfere.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef SCRATCH_BUFFER_
+#define SCRATCH_BUFFER_
+
+/** @class ScratchBuffer ScratchBuffer.h "ScratchBuffer.h"
+ *
+ *  Scoped loan of a thread-local container. The container is cleared
+ *  when borrowed but keeps its capacity. */
+template <typename Container, typename Tag = Container>
+class ScratchBuffer {
+public:
+    ScratchBuffer()
+    : owner(!inUse() ) {
+        if (owner) {
+            inUse() = true;
+            shared().clear();
+        }
+    }
+
+    ~ScratchBuffer() {
+        if (owner) {
+            inUse() = false;
+        }
+    }
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    Container& get() { return owner ? shared() : local; }
+
+private:
+    static Container& shared() {
+        static thread_local Container container;
+        return container;
+    }
+
+    static bool& inUse() {
+        static thread_local bool borrowed = false;
+        return borrowed;
+    }
+
+    bool owner;
+    Container local;
+};
+
+#endif
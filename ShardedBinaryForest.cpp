@@ -0,0 +1,194 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for a forest of independently locked
+ *  BinaryNodeTree shards.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//////////////////////////////////////////////////////////////
+//      Protected Utility Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+typename ShardedBinaryForest<ItemType>::Shard&
+ShardedBinaryForest<ItemType>::shardFor(const ItemType& anItem) const {
+
+    // std::hash is the identity for integers; mix it (splitmix64
+    // finalizer) so that runs of consecutive items spread out.
+    std::uint64_t bits(std::hash<ItemType>()(anItem) );
+    bits = (bits ^ (bits >> 30) ) * 0xbf58476d1ce4e5b9ULL;
+    bits = (bits ^ (bits >> 27) ) * 0x94d049bb133111ebULL;
+    bits ^= bits >> 31;
+    return shards[bits % numberOfShards];
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+ShardedBinaryForest<ItemType>::ShardedBinaryForest(std::size_t shardCount)
+: shards(new Shard[shardCount]),
+  numberOfShards(shardCount) {
+}
+
+//////////////////////////////////////////////////////////////
+//      Per-item Operations
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool ShardedBinaryForest<ItemType>::add(const ItemType& newData) {
+
+    auto& shard(shardFor(newData) );
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.tree.add(newData);
+}
+
+template <typename ItemType>
+bool ShardedBinaryForest<ItemType>::remove(const ItemType& data) {
+
+    auto& shard(shardFor(data) );
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.tree.remove(data);
+}
+
+template <typename ItemType>
+bool ShardedBinaryForest<ItemType>::contains(const ItemType& anEntry) const {
+
+    auto& shard(shardFor(anEntry) );
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.tree.contains(anEntry);
+}
+
+//////////////////////////////////////////////////////////////
+//      Whole-forest Operations
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+std::size_t ShardedBinaryForest<ItemType>::shardCount() const {
+
+    return numberOfShards;
+}
+
+template <typename ItemType>
+bool ShardedBinaryForest<ItemType>::isEmpty() const {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        if (!shards[i].tree.isEmpty() ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ItemType>
+int ShardedBinaryForest<ItemType>::getNumberOfNodes() const {
+
+    int count(0);
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        count += shards[i].tree.getNumberOfNodes();
+    }
+    return count;
+}
+
+template <typename ItemType>
+void ShardedBinaryForest<ItemType>::clear() {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].tree.clear();
+    }
+}
+
+template <typename ItemType>
+void ShardedBinaryForest<ItemType>::preorderTraverse(void visit(ItemType&) ) {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].tree.preorderTraverse(visit);
+    }
+}
+
+template <typename ItemType>
+void ShardedBinaryForest<ItemType>::inorderTraverse(void visit(ItemType&) ) {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].tree.inorderTraverse(visit);
+    }
+}
+
+template <typename ItemType>
+void ShardedBinaryForest<ItemType>::postorderTraverse(void visit(ItemType&) ) {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].tree.postorderTraverse(visit);
+    }
+}
+
+template <typename ItemType>
+void ShardedBinaryForest<ItemType>::levelorderTraverse(void visit(ItemType&) ) {
+
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].tree.levelorderTraverse(visit);
+    }
+}
+
+template <typename ItemType>
+typename SimdSum<ItemType>::type ShardedBinaryForest<ItemType>::sum() const {
+
+    typename SimdSum<ItemType>::type total(0);
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        total += shards[i].tree.sum();
+    }
+    return total;
+}
+
+template <typename ItemType>
+template <typename Predicate>
+std::size_t ShardedBinaryForest<ItemType>::countIf(Predicate pred) const {
+
+    std::size_t count(0);
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        count += shards[i].tree.countIf(pred);
+    }
+    return count;
+}
+
+template <typename ItemType>
+BinaryNodeTree<ItemType> ShardedBinaryForest<ItemType>::consolidate() const {
+
+    // The copies share the shards' nodes; merge clones shared nodes,
+    // so the shards themselves are not modified.
+    std::vector<BinaryNodeTree<ItemType>> parts(numberOfShards);
+    for (std::size_t i(0); i < numberOfShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        parts[i] = shards[i].tree;
+    }
+
+    // Merge in rounds of pairs, so each item is relinked O(log N)
+    // times rather than up to N times.
+    for (std::size_t stride(1); stride < parts.size(); stride *= 2) {
+        for (std::size_t i(0); i + stride < parts.size(); i += 2 * stride) {
+            parts[i].merge(parts[i + stride]);
+        }
+    }
+    return parts.empty() ? BinaryNodeTree<ItemType>() : parts.front();
+}
@@ -0,0 +1,95 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a forest of independently locked BinaryNodeTree
+ *  shards.
+ *
+ *  A BinaryNodeTree can be modified by only one thread at a time,
+ *  because every add goes through the root. The forest routes each
+ *  item to one of N shards by its hash, and each shard has its own
+ *  mutex. Threads that touch different shards therefore never wait
+ *  for each other. Equal items always land in the same shard.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef SHARDED_BINARY_FOREST_
+#define SHARDED_BINARY_FOREST_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "BinaryNodeTree.h"
+#include "SimdKernels.h"
+
+/** @class ShardedBinaryForest ShardedBinaryForest.h "ShardedBinaryForest.h"
+ *
+ *  Thread-safe multiset of items spread over per-shard-locked trees.
+ *  Whole-forest operations (traversals, reductions, consolidate) lock
+ *  one shard at a time, so they see each shard consistently but not
+ *  a single snapshot of the whole forest. */
+template <typename ItemType>
+class ShardedBinaryForest {
+private:
+    // One tree and its lock, padded to a cache line so that threads
+    // working on neighbouring shards do not share one.
+    struct alignas(64) Shard {
+        mutable std::mutex lock;
+        BinaryNodeTree<ItemType> tree;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t numberOfShards;
+
+protected:
+    // The shard that owns anItem.
+    Shard& shardFor(const ItemType& anItem) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    // @pre shardCount > 0.
+    explicit ShardedBinaryForest(std::size_t shardCount = 16);
+
+    ShardedBinaryForest(const ShardedBinaryForest&) = delete;
+    ShardedBinaryForest& operator=(const ShardedBinaryForest&) = delete;
+
+    //------------------------------------------------------------
+    // Per-item operations; each locks only the item's shard.
+    //------------------------------------------------------------
+    bool add(const ItemType& newData);
+    bool remove(const ItemType& data);
+    bool contains(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Whole-forest operations.
+    //------------------------------------------------------------
+    std::size_t shardCount() const;
+    bool isEmpty() const;
+    int getNumberOfNodes() const;
+    void clear();
+
+    // Each traversal walks the shards in order, one after another.
+    void preorderTraverse(void visit(ItemType&) );
+    void inorderTraverse(void visit(ItemType&) );
+    void postorderTraverse(void visit(ItemType&) );
+    void levelorderTraverse(void visit(ItemType&) );
+
+    typename SimdSum<ItemType>::type sum() const;
+    template <typename Predicate>
+    std::size_t countIf(Predicate pred) const;
+
+    // A single balanced tree holding every item, built in O(n) with
+    // BinaryNodeTree::merge. The forest is left unchanged.
+    BinaryNodeTree<ItemType> consolidate() const;
+};
+
+#include "ShardedBinaryForest.cpp"
+
+#endif
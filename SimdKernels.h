@@ -0,0 +1,344 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for vectorized reductions over a contiguous array of
+ *  items.
+ *
+ *  The generic templates are plain scalar loops. int and double have
+ *  overloads that use AVX2 when the translation unit is compiled with
+ *  it (__AVX2__), otherwise SSE4.1 / SSE2 where those are available,
+ *  and otherwise fall back to the scalar loops. The choice is made at
+ *  compile time; there is no run-time dispatch.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef SIMD_KERNELS_
+#define SIMD_KERNELS_
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/** Accumulator type used by simdSum: integers are summed in long long
+ *  so that a sum of ints cannot overflow, floating-point types in
+ *  their own type. */
+template <typename ItemType>
+struct SimdSum {
+    using type = typename std::conditional<std::is_integral<ItemType>::value,
+                                           long long,
+                                           ItemType>::type;
+};
+
+//////////////////////////////////////////////////////////////
+//      Scalar Kernels
+//////////////////////////////////////////////////////////////
+
+/** @pre count > 0. */
+template <typename ItemType>
+ItemType simdMin(const ItemType* data, std::size_t count) {
+    ItemType result(data[0]);
+    for (std::size_t i(1); i < count; ++i) {
+        if (data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+/** @pre count > 0. */
+template <typename ItemType>
+ItemType simdMax(const ItemType* data, std::size_t count) {
+    ItemType result(data[0]);
+    for (std::size_t i(1); i < count; ++i) {
+        if (result < data[i]) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+template <typename ItemType>
+typename SimdSum<ItemType>::type simdSum(const ItemType* data, std::size_t count) {
+    typename SimdSum<ItemType>::type result(0);
+    for (std::size_t i(0); i < count; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+template <typename ItemType>
+bool simdContains(const ItemType* data, std::size_t count, const ItemType& target) {
+    for (std::size_t i(0); i < count; ++i) {
+        if (data[i] == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Branch-free so that the compiler can vectorize it for simple
+// predicates.
+template <typename ItemType, typename Predicate>
+std::size_t simdCountIf(const ItemType* data, std::size_t count, Predicate pred) {
+    std::size_t result(0);
+    for (std::size_t i(0); i < count; ++i) {
+        result += pred(data[i]) ? 1 : 0;
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////////
+//      int Kernels
+//////////////////////////////////////////////////////////////
+
+inline int simdMin(const int* data, std::size_t count) {
+    std::size_t i(0);
+    int result(data[0]);
+#if defined(__AVX2__)
+    if (count >= 8) {
+        __m256i acc(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) ) );
+        for (i = 8; i + 8 <= count; i += 8) {
+            acc = _mm256_min_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i) ) );
+        }
+        __m128i half(_mm_min_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1) ) );
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2) ) );
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1) ) );
+        result = _mm_cvtsi128_si32(half);
+    }
+#elif defined(__SSE4_1__)
+    if (count >= 4) {
+        __m128i acc(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data) ) );
+        for (i = 4; i + 4 <= count; i += 4) {
+            acc = _mm_min_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i) ) );
+        }
+        acc = _mm_min_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2) ) );
+        acc = _mm_min_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1) ) );
+        result = _mm_cvtsi128_si32(acc);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+inline int simdMax(const int* data, std::size_t count) {
+    std::size_t i(0);
+    int result(data[0]);
+#if defined(__AVX2__)
+    if (count >= 8) {
+        __m256i acc(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) ) );
+        for (i = 8; i + 8 <= count; i += 8) {
+            acc = _mm256_max_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i) ) );
+        }
+        __m128i half(_mm_max_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1) ) );
+        half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2) ) );
+        half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1) ) );
+        result = _mm_cvtsi128_si32(half);
+    }
+#elif defined(__SSE4_1__)
+    if (count >= 4) {
+        __m128i acc(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data) ) );
+        for (i = 4; i + 4 <= count; i += 4) {
+            acc = _mm_max_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i) ) );
+        }
+        acc = _mm_max_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2) ) );
+        acc = _mm_max_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1) ) );
+        result = _mm_cvtsi128_si32(acc);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (result < data[i]) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+inline long long simdSum(const int* data, std::size_t count) {
+    std::size_t i(0);
+    long long result(0);
+#if defined(__AVX2__)
+    // Widen to 64-bit lanes so that the partial sums cannot overflow.
+    __m256i acc(_mm256_setzero_si256() );
+    for (; i + 8 <= count; i += 8) {
+        __m256i block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i) ) );
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block) ) );
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1) ) );
+    }
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE4_1__)
+    __m128i acc(_mm_setzero_si128() );
+    for (; i + 4 <= count; i += 4) {
+        __m128i block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i) ) );
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(block) );
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(block, 8) ) );
+    }
+    alignas(16) long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    result = lanes[0] + lanes[1];
+#endif
+    for (; i < count; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+inline bool simdContains(const int* data, std::size_t count, const int& target) {
+    std::size_t i(0);
+#if defined(__AVX2__)
+    __m256i needle(_mm256_set1_epi32(target) );
+    for (; i + 8 <= count; i += 8) {
+        __m256i block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i) ) );
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, needle) ) != 0) {
+            return true;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needle(_mm_set1_epi32(target) );
+    for (; i + 4 <= count; i += 4) {
+        __m128i block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i) ) );
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needle) ) != 0) {
+            return true;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (data[i] == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////
+//      double Kernels
+//////////////////////////////////////////////////////////////
+
+// The vector min/max/sum kernels follow the SIMD lane order, so NaNs
+// and the rounding of sums may differ from a sequential loop.
+
+inline double simdMin(const double* data, std::size_t count) {
+    std::size_t i(0);
+    double result(data[0]);
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256d acc(_mm256_loadu_pd(data) );
+        for (i = 4; i + 4 <= count; i += 4) {
+            acc = _mm256_min_pd(acc, _mm256_loadu_pd(data + i) );
+        }
+        __m128d half(_mm_min_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1) ) );
+        half = _mm_min_sd(half, _mm_unpackhi_pd(half, half) );
+        result = _mm_cvtsd_f64(half);
+    }
+#elif defined(__SSE2__)
+    if (count >= 2) {
+        __m128d acc(_mm_loadu_pd(data) );
+        for (i = 2; i + 2 <= count; i += 2) {
+            acc = _mm_min_pd(acc, _mm_loadu_pd(data + i) );
+        }
+        acc = _mm_min_sd(acc, _mm_unpackhi_pd(acc, acc) );
+        result = _mm_cvtsd_f64(acc);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+inline double simdMax(const double* data, std::size_t count) {
+    std::size_t i(0);
+    double result(data[0]);
+#if defined(__AVX2__)
+    if (count >= 4) {
+        __m256d acc(_mm256_loadu_pd(data) );
+        for (i = 4; i + 4 <= count; i += 4) {
+            acc = _mm256_max_pd(acc, _mm256_loadu_pd(data + i) );
+        }
+        __m128d half(_mm_max_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1) ) );
+        half = _mm_max_sd(half, _mm_unpackhi_pd(half, half) );
+        result = _mm_cvtsd_f64(half);
+    }
+#elif defined(__SSE2__)
+    if (count >= 2) {
+        __m128d acc(_mm_loadu_pd(data) );
+        for (i = 2; i + 2 <= count; i += 2) {
+            acc = _mm_max_pd(acc, _mm_loadu_pd(data + i) );
+        }
+        acc = _mm_max_sd(acc, _mm_unpackhi_pd(acc, acc) );
+        result = _mm_cvtsd_f64(acc);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (result < data[i]) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+inline double simdSum(const double* data, std::size_t count) {
+    std::size_t i(0);
+    double result(0.0);
+#if defined(__AVX2__)
+    __m256d acc(_mm256_setzero_pd() );
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(data + i) );
+    }
+    __m128d half(_mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1) ) );
+    result = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half) ) );
+#elif defined(__SSE2__)
+    __m128d acc(_mm_setzero_pd() );
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_pd(acc, _mm_loadu_pd(data + i) );
+    }
+    result = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc) ) );
+#endif
+    for (; i < count; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+inline bool simdContains(const double* data, std::size_t count, const double& target) {
+    std::size_t i(0);
+#if defined(__AVX2__)
+    __m256d needle(_mm256_set1_pd(target) );
+    for (; i + 4 <= count; i += 4) {
+        if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data + i), needle, _CMP_EQ_OQ) ) != 0) {
+            return true;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128d needle(_mm_set1_pd(target) );
+    for (; i + 2 <= count; i += 2) {
+        if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), needle) ) != 0) {
+            return true;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (data[i] == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,245 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for a fixed-size binary tree that can be built
+ *  and queried at compile time.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <limits>
+#include <type_traits>
+
+//////////////////////////////////////////////////////////////
+//      Protected Utility Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType, std::size_t N>
+constexpr int StaticBinaryTree<ItemType, N>::heightHelper(std::size_t node) const {
+
+    if (node == npos) {
+        return 0;
+    }
+    const int leftHeight(heightHelper(leftChild[node]) );
+    const int rightHeight(heightHelper(rightChild[node]) );
+    return 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+}
+
+// Same bounds as BinaryNodeTree::BSTHelper, so both give the same
+// answer for the same tree: each item may exceed the bounds its
+// ancestors set by at most one.
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::bstHelper(std::size_t node,
+                                                        ItemType min,
+                                                        ItemType max) const {
+
+    if (node == npos) {
+        return true;
+    }
+    if (aboveBound(items[node], max) || belowBound(items[node], min) ) {
+        return false;
+    }
+    return bstHelper(leftChild[node], min, items[node]) &&
+           bstHelper(rightChild[node], items[node], max);
+}
+
+// For integers, item > bound + 1 exactly when item > bound and
+// item - 1 != bound, and item - 1 cannot overflow once item > bound.
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::aboveBound(const ItemType& item,
+                                                         const ItemType& bound) {
+
+    if constexpr (std::is_integral<ItemType>::value) {
+        return item > bound && item - 1 != bound;
+    }
+    else {
+        return item > bound + 1;
+    }
+}
+
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::belowBound(const ItemType& item,
+                                                         const ItemType& bound) {
+
+    if constexpr (std::is_integral<ItemType>::value) {
+        return item < bound && item + 1 != bound;
+    }
+    else {
+        return item < bound - 1;
+    }
+}
+
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::pathSumHelper(std::size_t node,
+                                                            typename PathSumTraits<ItemType>::type sum,
+                                                            typename PathSumTraits<ItemType>::type value) const {
+
+    sum = checkedAdd(sum, static_cast<typename PathSumTraits<ItemType>::type>(items[node]) );
+    if (leftChild[node] == npos && rightChild[node] == npos) {
+        return sum == value;
+    }
+    return (leftChild[node] != npos && pathSumHelper(leftChild[node], sum, value) ) ||
+           (rightChild[node] != npos && pathSumHelper(rightChild[node], sum, value) );
+}
+
+template <typename ItemType, std::size_t N>
+template <typename Visitor>
+constexpr void StaticBinaryTree<ItemType, N>::preorder(std::size_t node, Visitor& visit) const {
+
+    if (node != npos) {
+        visit(items[node]);
+        preorder(leftChild[node], visit);
+        preorder(rightChild[node], visit);
+    }
+}
+
+template <typename ItemType, std::size_t N>
+template <typename Visitor>
+constexpr void StaticBinaryTree<ItemType, N>::inorder(std::size_t node, Visitor& visit) const {
+
+    if (node != npos) {
+        inorder(leftChild[node], visit);
+        visit(items[node]);
+        inorder(rightChild[node], visit);
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType, std::size_t N>
+constexpr StaticBinaryTree<ItemType, N>::StaticBinaryTree(const ItemType (&newItems)[N]) {
+
+    // Replays balancedAdd: below each node the new item goes right if
+    // the left subtree is taller, else left. Heights are kept per node
+    // and updated along the insertion path.
+    int height[N] = {};
+    std::size_t path[N] = {};
+    auto heightOf = [&height](std::size_t node) { return node == npos ? 0 : height[node]; };
+
+    for (std::size_t added(0); added < N; ++added) {
+        items[added] = newItems[added];
+        leftChild[added] = npos;
+        rightChild[added] = npos;
+        height[added] = 1;
+        if (added == 0) {
+            continue;
+        }
+
+        std::size_t depth(0);
+        std::size_t node(0);
+        for (;;) {
+            path[depth++] = node;
+            auto& next(heightOf(leftChild[node]) > heightOf(rightChild[node]) ? rightChild[node]
+                                                                               : leftChild[node]);
+            if (next == npos) {
+                next = added;
+                break;
+            }
+            node = next;
+        }
+        while (depth > 0) {
+            node = path[--depth];
+            const int leftHeight(heightOf(leftChild[node]) );
+            const int rightHeight(heightOf(rightChild[node]) );
+            height[node] = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Const BinaryTreeInterface Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType, std::size_t N>
+constexpr int StaticBinaryTree<ItemType, N>::getHeight() const {
+
+    return heightHelper(0);
+}
+
+template <typename ItemType, std::size_t N>
+constexpr int StaticBinaryTree<ItemType, N>::getNumberOfNodes() const {
+
+    return static_cast<int>(N);
+}
+
+template <typename ItemType, std::size_t N>
+constexpr ItemType StaticBinaryTree<ItemType, N>::getRootData() const {
+
+    return items[0];
+}
+
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::contains(const ItemType& anEntry) const {
+
+    for (std::size_t i(0); i < N; ++i) {
+        if (items[i] == anEntry) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////
+//      Queries
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType, std::size_t N>
+constexpr ItemType StaticBinaryTree<ItemType, N>::getMax() const {
+
+    ItemType result(items[0]);
+    for (std::size_t i(1); i < N; ++i) {
+        if (result < items[i]) {
+            result = items[i];
+        }
+    }
+    return result;
+}
+
+template <typename ItemType, std::size_t N>
+constexpr ItemType StaticBinaryTree<ItemType, N>::getMin() const {
+
+    ItemType result(items[0]);
+    for (std::size_t i(1); i < N; ++i) {
+        if (items[i] < result) {
+            result = items[i];
+        }
+    }
+    return result;
+}
+
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::BST() const {
+
+    return bstHelper(0, std::numeric_limits<ItemType>::lowest(), std::numeric_limits<ItemType>::max() );
+}
+
+template <typename ItemType, std::size_t N>
+constexpr bool StaticBinaryTree<ItemType, N>::doesSomePathHaveSum(int value) const {
+
+    return pathSumHelper(0, 0, value);
+}
+
+//////////////////////////////////////////////////////////////
+//      Traversals Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType, std::size_t N>
+template <typename Visitor>
+constexpr void StaticBinaryTree<ItemType, N>::preorderTraverse(Visitor visit) const {
+
+    preorder(0, visit);
+}
+
+template <typename ItemType, std::size_t N>
+template <typename Visitor>
+constexpr void StaticBinaryTree<ItemType, N>::inorderTraverse(Visitor visit) const {
+
+    inorder(0, visit);
+}
@@ -0,0 +1,103 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a fixed-size binary tree that can be built and
+ *  queried at compile time.
+ *
+ *  The nodes live in arrays inside the object, linked by index, and
+ *  the constructor places the items exactly as repeated calls to
+ *  BinaryNodeTree::add would. A constexpr StaticBinaryTree therefore
+ *  sits in read-only data with no allocation and no startup cost,
+ *  while answering the same queries as the equivalent BinaryNodeTree.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef STATIC_BINARY_TREE_
+#define STATIC_BINARY_TREE_
+
+#include <cstddef>
+#include "PathSumTraits.h"
+
+/** @class StaticBinaryTree StaticBinaryTree.h "StaticBinaryTree.h"
+ *
+ *  Immutable tree of N items; ItemType must be a literal type.
+ *
+ *  constexpr StaticBinaryTree<int, 3> table({5, 8, 4});
+ *  static_assert(table.contains(8), ""); */
+template <typename ItemType, std::size_t N>
+class StaticBinaryTree {
+    static_assert(N > 0, "A StaticBinaryTree holds at least one item.");
+
+public:
+    static constexpr std::size_t npos = ~std::size_t(0);
+
+private:
+    // Node i holds items[i]; its children are the nodes leftChild[i]
+    // and rightChild[i] (npos if absent). Node 0 is the root.
+    ItemType items[N] = {};
+    std::size_t leftChild[N] = {};
+    std::size_t rightChild[N] = {};
+
+protected:
+    //------------------------------------------------------------
+    // Protected Utility Methods Section:
+    // Recursive helper methods for the public methods.
+    //------------------------------------------------------------
+    constexpr int heightHelper(std::size_t node) const;
+    constexpr bool bstHelper(std::size_t node, ItemType min, ItemType max) const;
+    // item > bound + 1 and item < bound - 1, without computing
+    // bound +/- 1, which would overflow at the ends of an integer type.
+    static constexpr bool aboveBound(const ItemType& item, const ItemType& bound);
+    static constexpr bool belowBound(const ItemType& item, const ItemType& bound);
+    constexpr bool pathSumHelper(std::size_t node,
+                                 typename PathSumTraits<ItemType>::type sum,
+                                 typename PathSumTraits<ItemType>::type value) const;
+    template <typename Visitor>
+    constexpr void preorder(std::size_t node, Visitor& visit) const;
+    template <typename Visitor>
+    constexpr void inorder(std::size_t node, Visitor& visit) const;
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    // Adds the items in order, as BinaryNodeTree::add does.
+    constexpr StaticBinaryTree(const ItemType (&newItems)[N]);
+
+    //------------------------------------------------------------
+    // Const BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    constexpr int getHeight() const;
+    constexpr int getNumberOfNodes() const;
+    constexpr ItemType getRootData() const;
+    constexpr bool contains(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Queries matching BinaryNodeTree's.
+    //------------------------------------------------------------
+    constexpr ItemType getMax() const;
+    constexpr ItemType getMin() const;
+    constexpr bool BST() const;
+    // @throws std::overflow_error If a path sum does not fit in the
+    //         PathSumTraits accumulator; in a constant expression
+    //         this is a compile error instead.
+    constexpr bool doesSomePathHaveSum(int value) const;
+
+    //------------------------------------------------------------
+    // Traversals Section. visit takes const ItemType&.
+    //------------------------------------------------------------
+    template <typename Visitor>
+    constexpr void preorderTraverse(Visitor visit) const;
+    template <typename Visitor>
+    constexpr void inorderTraverse(Visitor visit) const;
+};
+
+#include "StaticBinaryTree.cpp"
+
+#endif
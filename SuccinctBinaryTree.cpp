@@ -0,0 +1,302 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Implementation file for a read-only, succinct encoding of a binary
+ *  tree.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "PrecondViolatedExcep.h"
+#include "NotFoundException.h"
+#include "RingQueue.h"
+#include "ScratchBuffer.h"
+#include "SimdKernels.h"
+
+//////////////////////////////////////////////////////////////
+//      Protected Navigation Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+std::size_t SuccinctBinaryTree<ItemType>::leftChild(std::size_t node) const {
+
+    const std::size_t bit(2 * node);
+    return shape.get(bit) ? shape.rank1(bit) + 1 : npos;
+}
+
+template <typename ItemType>
+std::size_t SuccinctBinaryTree<ItemType>::rightChild(std::size_t node) const {
+
+    const std::size_t bit(2 * node + 1);
+    return shape.get(bit) ? shape.rank1(bit) + 1 : npos;
+}
+
+template <typename ItemType>
+std::size_t SuccinctBinaryTree<ItemType>::parent(std::size_t node) const {
+
+    return node == 0 ? npos : shape.select1(node - 1) / 2;
+}
+
+template <typename ItemType>
+std::size_t SuccinctBinaryTree<ItemType>::findIndex(const ItemType& anEntry) const {
+
+    auto found(std::find(items.begin(), items.end(), anEntry) );
+    return found == items.end() ? npos : static_cast<std::size_t>(found - items.begin() );
+}
+
+//////////////////////////////////////////////////////////////
+//      Constructor Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+SuccinctBinaryTree<ItemType>::SuccinctBinaryTree(const BinaryNodeTree<ItemType>& tree) {
+
+    using NodeView = typename BinaryNodeTree<ItemType>::NodeView;
+
+    struct EncodeQueueTag {};
+    ScratchBuffer<RingQueue<NodeView>, EncodeQueueTag> scratch;
+    auto& queue(scratch.get() );
+
+    if (!tree.isEmpty() ) {
+        queue.enqueue(tree.rootView() );
+    }
+    while (!queue.isEmpty() ) {
+        auto node(queue.peekFront() );
+        queue.dequeue();
+
+        items.push_back(node.item() );
+        shape.pushBack(static_cast<bool>(node.left() ) );
+        shape.pushBack(static_cast<bool>(node.right() ) );
+        if (node.left() ) {
+            queue.enqueue(node.left() );
+        }
+        if (node.right() ) {
+            queue.enqueue(node.right() );
+        }
+    }
+    items.shrink_to_fit();
+    shape.finalize();
+}
+
+//////////////////////////////////////////////////////////////
+//      Const BinaryTreeInterface Methods Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+bool SuccinctBinaryTree<ItemType>::isEmpty() const {
+
+    return items.empty();
+}
+
+template <typename ItemType>
+int SuccinctBinaryTree<ItemType>::getHeight() const {
+
+    // The last node in level order is one of the deepest.
+    int height(0);
+    for (std::size_t node(isEmpty() ? npos : items.size() - 1); node != npos; node = parent(node) ) {
+        ++height;
+    }
+    return height;
+}
+
+template <typename ItemType>
+int SuccinctBinaryTree<ItemType>::getNumberOfNodes() const {
+
+    return static_cast<int>(items.size() );
+}
+
+template <typename ItemType>
+ItemType SuccinctBinaryTree<ItemType>::getRootData() const {
+
+    if (isEmpty() ) {
+        std::string message("SuccinctBinaryTree::getRootData: called ");
+        message += "on an empty tree.";
+
+        throw PrecondViolatedExcep(message);
+    }
+    return items.front();
+}
+
+template <typename ItemType>
+ItemType SuccinctBinaryTree<ItemType>::getEntry(const ItemType& anEntry) const {
+
+    auto index(findIndex(anEntry) );
+
+    if (index == npos) {
+        std::string message("SuccinctBinaryTree::getEntry: Entry ");
+        message += "not found in this tree.";
+        throw NotFoundException(message);
+    }
+    return items[index];
+}
+
+template <typename ItemType>
+bool SuccinctBinaryTree<ItemType>::contains(const ItemType& anEntry) const {
+
+    return simdContains(items.data(), items.size(), anEntry);
+}
+
+//////////////////////////////////////////////////////////////
+//      Traversals Section
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+template <typename Visitor>
+void SuccinctBinaryTree<ItemType>::preorderTraverse(Visitor visit) const {
+
+    ScratchBuffer<std::vector<std::size_t>> scratch;
+    auto& pending(scratch.get() );
+    if (!isEmpty() ) {
+        pending.push_back(0);
+    }
+    while (!pending.empty() ) {
+        auto node(pending.back() );
+        pending.pop_back();
+        visit(items[node]);
+
+        auto right(rightChild(node) );
+        if (right != npos) {
+            pending.push_back(right);
+        }
+        auto left(leftChild(node) );
+        if (left != npos) {
+            pending.push_back(left);
+        }
+    }
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void SuccinctBinaryTree<ItemType>::inorderTraverse(Visitor visit) const {
+
+    ScratchBuffer<std::vector<std::size_t>> scratch;
+    auto& pending(scratch.get() );
+    auto node(isEmpty() ? npos : 0);
+    while (node != npos || !pending.empty() ) {
+        while (node != npos) {
+            pending.push_back(node);
+            node = leftChild(node);
+        }
+        node = pending.back();
+        pending.pop_back();
+        visit(items[node]);
+        node = rightChild(node);
+    }
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void SuccinctBinaryTree<ItemType>::postorderTraverse(Visitor visit) const {
+
+    // A node is pushed twice: first to expand it, then, below its
+    // children, to visit it.
+    ScratchBuffer<std::vector<std::pair<std::size_t, bool>>> scratch;
+    auto& pending(scratch.get() );
+    if (!isEmpty() ) {
+        pending.emplace_back(0, false);
+    }
+    while (!pending.empty() ) {
+        auto entry(pending.back() );
+        pending.pop_back();
+        if (entry.second) {
+            visit(items[entry.first]);
+            continue;
+        }
+        pending.emplace_back(entry.first, true);
+        auto right(rightChild(entry.first) );
+        if (right != npos) {
+            pending.emplace_back(right, false);
+        }
+        auto left(leftChild(entry.first) );
+        if (left != npos) {
+            pending.emplace_back(left, false);
+        }
+    }
+}
+
+template <typename ItemType>
+template <typename Visitor>
+void SuccinctBinaryTree<ItemType>::levelorderTraverse(Visitor visit) const {
+
+    // Level order is storage order.
+    for (const auto& item : items) {
+        visit(item);
+    }
+}
+
+//////////////////////////////////////////////////////////////
+//      Path Queries
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+std::vector<ItemType> SuccinctBinaryTree<ItemType>::pathTo(const ItemType& anEntry) const {
+
+    auto index(findIndex(anEntry) );
+
+    if (index == npos) {
+        std::string message("SuccinctBinaryTree::pathTo: Entry ");
+        message += "not found in this tree.";
+        throw NotFoundException(message);
+    }
+
+    std::vector<ItemType> path;
+    for (; index != npos; index = parent(index) ) {
+        path.push_back(items[index]);
+    }
+    std::reverse(path.begin(), path.end() );
+    return path;
+}
+
+template <typename ItemType>
+bool SuccinctBinaryTree<ItemType>::doesSomePathHaveSum(int value) const {
+
+    using Accumulator = typename PathSumTraits<ItemType>::type;
+    ScratchBuffer<std::vector<std::pair<std::size_t, Accumulator>>> scratch;
+    auto& pending(scratch.get() );
+    if (!isEmpty() ) {
+        pending.emplace_back(0, static_cast<Accumulator>(items[0]) );
+    }
+    while (!pending.empty() ) {
+        auto entry(pending.back() );
+        pending.pop_back();
+        auto left(leftChild(entry.first) );
+        auto right(rightChild(entry.first) );
+        if (left == npos && right == npos) {
+            if (entry.second == static_cast<Accumulator>(value) ) {
+                return true;
+            }
+            continue;
+        }
+        if (right != npos) {
+            pending.emplace_back(right, checkedAdd(entry.second, static_cast<Accumulator>(items[right]) ) );
+        }
+        if (left != npos) {
+            pending.emplace_back(left, checkedAdd(entry.second, static_cast<Accumulator>(items[left]) ) );
+        }
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////
+//      Memory Report
+//////////////////////////////////////////////////////////////
+
+template <typename ItemType>
+double SuccinctBinaryTree<ItemType>::bytesPerNode() const {
+
+    if (isEmpty() ) {
+        return 0.0;
+    }
+    return static_cast<double>(sizeof(*this) + shape.sizeInBytes() +
+                               items.capacity() * sizeof(ItemType) ) /
+           static_cast<double>(items.size() );
+}
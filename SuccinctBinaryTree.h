@@ -0,0 +1,101 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for a read-only, succinct encoding of a binary tree.
+ *
+ *  The shape is stored in about 2n bits. The nodes are numbered in
+ *  level order, and node i owns bits 2i and 2i + 1, which are set if
+ *  it has a left or right child. The j-th set bit belongs to node
+ *  j + 1, so children are found with rank and parents with select.
+ *  This level-order bitmap supports the same navigation as a balanced
+ *  parentheses sequence with simpler directories. The items are kept
+ *  in one packed array in the same order.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef SUCCINCT_BINARY_TREE_
+#define SUCCINCT_BINARY_TREE_
+
+#include <cstddef>
+#include <vector>
+#include "BinaryNodeTree.h"
+#include "PathSumTraits.h"
+#include "RankSelectBitVector.h"
+
+/** @class SuccinctBinaryTree SuccinctBinaryTree.h "SuccinctBinaryTree.h"
+ *
+ *  Immutable snapshot of a BinaryNodeTree (as seen through any pending
+ *  flips) answering the const queries directly on the encoding. The
+ *  traversals take any callable accepting const ItemType&. */
+template <typename ItemType>
+class SuccinctBinaryTree {
+protected:
+    static constexpr std::size_t npos = ~std::size_t(0);
+
+    // Navigation by level-order index; npos if there is no such node.
+    std::size_t leftChild(std::size_t node) const;
+    std::size_t rightChild(std::size_t node) const;
+    std::size_t parent(std::size_t node) const;
+
+    // Level-order index of the first item equal to anEntry, or npos.
+    std::size_t findIndex(const ItemType& anEntry) const;
+
+private:
+    RankSelectBitVector shape;
+    std::vector<ItemType> items;
+
+public:
+    //------------------------------------------------------------
+    // Constructor Section.
+    //------------------------------------------------------------
+    explicit SuccinctBinaryTree(const BinaryNodeTree<ItemType>& tree);
+
+    //------------------------------------------------------------
+    // Const BinaryTreeInterface Methods Section.
+    //------------------------------------------------------------
+    bool isEmpty() const;
+    int getHeight() const;
+    int getNumberOfNodes() const;
+    // @throws PrecondViolatedExcep If the tree is empty.
+    ItemType getRootData() const;
+    // @throws NotFoundException If the tree does not contain anEntry.
+    ItemType getEntry(const ItemType& anEntry) const;
+    bool contains(const ItemType& anEntry) const;
+
+    //------------------------------------------------------------
+    // Traversals Section.
+    //------------------------------------------------------------
+    template <typename Visitor>
+    void preorderTraverse(Visitor visit) const;
+    template <typename Visitor>
+    void inorderTraverse(Visitor visit) const;
+    template <typename Visitor>
+    void postorderTraverse(Visitor visit) const;
+    template <typename Visitor>
+    void levelorderTraverse(Visitor visit) const;
+
+    //------------------------------------------------------------
+    // Path queries.
+    //------------------------------------------------------------
+    // Items from the root down to the first node holding anEntry.
+    // @throws NotFoundException If the tree does not contain anEntry.
+    std::vector<ItemType> pathTo(const ItemType& anEntry) const;
+    // True if the items of some root-to-leaf path sum to value.
+    bool doesSomePathHaveSum(int value) const;
+
+    //------------------------------------------------------------
+    // Memory report: bytes of storage per node, counting the shape,
+    // its directory, the items and the object itself.
+    //------------------------------------------------------------
+    double bytesPerNode() const;
+};
+
+#include "SuccinctBinaryTree.cpp"
+
+#endif
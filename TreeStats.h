@@ -0,0 +1,233 @@
+/** @file
+ *
+ *  @course CS1521
+ *  @section 1
+ *
+ *  Header file for the optional hot-path instrumentation used by
+ *  BinaryNodeTree.
+ *
+ *  Instrumentation is selected at compile time. Define
+ *  BINARY_TREE_STATS to count nodes visited, height recomputations,
+ *  allocations, item copies and maximum recursion depth per operation
+ *  type; additionally define BINARY_TREE_STATS_LATENCY to record a
+ *  per-operation latency histogram. Without BINARY_TREE_STATS every
+ *  recorder call is an empty inline function and compiles away.
+ *
+ *  Recording is not synchronized; an instrumented tree must only be
+ *  used from one thread at a time.
+ *
+ *  @author Rudolf Musika
+ *
+ *  @date 19 Oct 2026
+ *
+ *  @version 7.0 */
+
+#ifndef TREE_STATS_
+#define TREE_STATS_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+/** Operation categories that instrumentation is grouped by. */
+enum class TreeOp : std::size_t {
+    Add,
+    Remove,
+    Contains,
+    GetEntry,
+    Height,
+    NodeCount,
+    Traverse,
+    Copy,
+    Flip,
+    Query,
+    Other,
+    NumOps
+};
+
+/** @class TreeOpCounters TreeStats.h "TreeStats.h"
+ *
+ *  Counters gathered for a single operation type. */
+struct TreeOpCounters {
+    unsigned long long calls = 0;
+    unsigned long long nodesVisited = 0;
+    unsigned long long heightRecomputations = 0;
+    unsigned long long allocations = 0;
+    unsigned long long itemCopies = 0;
+    unsigned int maxRecursionDepth = 0;
+};
+
+/** @class TreeLatencyHistogram TreeStats.h "TreeStats.h"
+ *
+ *  Power-of-two latency histogram. Bucket i counts the calls that
+ *  took between 2^i and 2^(i+1) - 1 nanoseconds. */
+struct TreeLatencyHistogram {
+    static constexpr std::size_t NUM_BUCKETS = 40;
+
+    std::array<unsigned long long, NUM_BUCKETS> buckets{};
+
+    void record(unsigned long long nanos) {
+        std::size_t bucket(0);
+        while (nanos > 1 && bucket + 1 < NUM_BUCKETS) {
+            nanos >>= 1;
+            ++bucket;
+        }
+        ++buckets[bucket];
+    }
+
+    unsigned long long samples() const {
+        unsigned long long total(0);
+        for (auto count : buckets) {
+            total += count;
+        }
+        return total;
+    }
+};
+
+/** @class TreeStats TreeStats.h "TreeStats.h"
+ *
+ *  Snapshot of the instrumentation counters of one tree. All counters
+ *  are zero when instrumentation is compiled out. */
+struct TreeStats {
+    static constexpr std::size_t NUM_OPS = static_cast<std::size_t>(TreeOp::NumOps);
+
+    std::array<TreeOpCounters, NUM_OPS> counters{};
+    std::array<TreeLatencyHistogram, NUM_OPS> latency{};
+
+    const TreeOpCounters& operator[](TreeOp op) const {
+        return counters[static_cast<std::size_t>(op)];
+    }
+
+    const TreeLatencyHistogram& latencyOf(TreeOp op) const {
+        return latency[static_cast<std::size_t>(op)];
+    }
+};
+
+#ifdef BINARY_TREE_STATS
+
+/** @class TreeStatsRecorder TreeStats.h "TreeStats.h"
+ *
+ *  Accumulates counters for the operation that is currently running.
+ *  Only the outermost OpScope selects the operation, so work done by a
+ *  public method on behalf of another (e.g. printRootLeaf calling
+ *  getHeight) is charged to the caller. */
+class TreeStatsRecorder {
+public:
+    class OpScope {
+    public:
+        OpScope(TreeStatsRecorder& recorder, TreeOp op)
+        : recorder(recorder), outermost(recorder.active == nullptr) {
+            if (outermost) {
+                recorder.active = &recorder.stats.counters[static_cast<std::size_t>(op)];
+                ++recorder.active->calls;
+#ifdef BINARY_TREE_STATS_LATENCY
+                histogram = &recorder.stats.latency[static_cast<std::size_t>(op)];
+                start = std::chrono::steady_clock::now();
+#endif
+            }
+        }
+
+        ~OpScope() {
+            if (outermost) {
+#ifdef BINARY_TREE_STATS_LATENCY
+                auto elapsed(std::chrono::steady_clock::now() - start);
+                histogram->record(static_cast<unsigned long long>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() ) );
+#endif
+                recorder.active = nullptr;
+                recorder.depth = 0;
+            }
+        }
+
+        OpScope(const OpScope&) = delete;
+        OpScope& operator=(const OpScope&) = delete;
+
+    private:
+        TreeStatsRecorder& recorder;
+        bool outermost;
+#ifdef BINARY_TREE_STATS_LATENCY
+        TreeLatencyHistogram* histogram = nullptr;
+        std::chrono::steady_clock::time_point start;
+#endif
+    };
+
+    class DepthScope {
+    public:
+        explicit DepthScope(TreeStatsRecorder& recorder)
+        : recorder(recorder) {
+            ++recorder.depth;
+            auto& counters(recorder.current() );
+            if (recorder.depth > counters.maxRecursionDepth) {
+                counters.maxRecursionDepth = recorder.depth;
+            }
+        }
+
+        ~DepthScope() {
+            --recorder.depth;
+        }
+
+        DepthScope(const DepthScope&) = delete;
+        DepthScope& operator=(const DepthScope&) = delete;
+
+    private:
+        TreeStatsRecorder& recorder;
+    };
+
+    void nodeVisited() { ++current().nodesVisited; }
+    void heightRecomputed() { ++current().heightRecomputations; }
+    void allocated() { ++current().allocations; }
+    void itemCopied() { ++current().itemCopies; }
+
+    // Reports an explicit-stack depth for iterative helpers.
+    void reachedDepth(unsigned int stackDepth) {
+        auto& counters(current() );
+        if (stackDepth > counters.maxRecursionDepth) {
+            counters.maxRecursionDepth = stackDepth;
+        }
+    }
+
+    TreeStats snapshot() const { return stats; }
+    void reset() { stats = TreeStats(); }
+
+private:
+    TreeOpCounters& current() {
+        return active ? *active
+                      : stats.counters[static_cast<std::size_t>(TreeOp::Other)];
+    }
+
+    TreeStats stats;
+    TreeOpCounters* active = nullptr;
+    unsigned int depth = 0;
+};
+
+#else
+
+/** @class TreeStatsRecorder TreeStats.h "TreeStats.h"
+ *
+ *  Instrumentation compiled out: every member is an empty inline
+ *  function. */
+class TreeStatsRecorder {
+public:
+    class OpScope {
+    public:
+        OpScope(TreeStatsRecorder&, TreeOp) {}
+    };
+
+    class DepthScope {
+    public:
+        explicit DepthScope(TreeStatsRecorder&) {}
+    };
+
+    void nodeVisited() {}
+    void heightRecomputed() {}
+    void allocated() {}
+    void itemCopied() {}
+    void reachedDepth(unsigned int) {}
+
+    TreeStats snapshot() const { return TreeStats(); }
+    void reset() {}
+};
+
+#endif
+
+#endif
@@ -5,63 +5,267 @@
 //  Created by Rudolf Musika on 4/17/18.
 //  Copyright © 2018 Rudolf Musika. All rights reserved.
 //
+//  Batch driver: builds one tree from a list of integers and answers a
+//  file of queries against it.
+//
+//  Usage: main [-i itemsFile] [-q queriesFile]
+//
+//  Items are whitespace-separated integers, read from itemsFile or
+//  else from standard input. Any other token, or one out of int
+//  range, is an error. The tree has the shape that adding the items
+//  one at a time, in order, gives. Each line of queriesFile is one
+//  query:
+//
+//      contains N    yes/no
+//      pathsum N     does some root-to-leaf path sum to N
+//      downsum N     number of downward paths summing to N
+//      min | max     smallest / largest item
+//      bst           does the tree hold a binary search tree
+//      height | size
+//      paths         every root-to-leaf path, one per line
+//
+//  Each answer is written to standard output as "query: answer".
+//  Per-phase timings go to standard error.
+//
 
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 #include "BinaryNode.h"
 #include "BinaryNodeTree.h"
-#include <algorithm>
-#include <iterator>
-int main() {
-    BinaryNodeTree<int> Tree;
-    Tree.add(5);
-    Tree.add(8);
-    Tree.add(4);
-    Tree.add(3);
-    Tree.add(7);
-    Tree.add(1);
-    Tree.add(2);
-    Tree.add(6);
-    std::cout<<"To simply display the contents of the Binary Tree\n"<<std::endl;
-    Tree.CallDisplay();
-   
-    std::cout<<"\n------------------------------\n"<<std::endl;
-    std::cout<<"\nTo flip the contents of the Binary Tree\n"<<std::endl;
-    Tree.flip();
-    Tree.CallDisplay();
-    std::cout<<"\n------------------------------\n"<<std::endl;
-    
-    std::cout<<"\nTest if this binary tree contains a binary search tree\n"<<std::endl;
-    if (Tree.BST() == true){
-        std::cout<<"\nThis is a binary tree that contains a binary search"<<std::endl;
-    }
-    else{
-        std::cout<<"\nThis is a binary tree that does not contain a binary search "<< Tree.BST()<<std::endl;
-    }
-    
-    std::cout<<"\n------------------------------\n"<<std::endl;
-    std::cout<<"\nTo find the maximum and minimum values onf Binary Tree\n"<<std::endl;
-    std::cout<<"\nTo find the maximum value is \n"<<Tree.getMax()<<std::endl;
-    std::cout<<"\nTo find the minimum value is \n"<<Tree.getMin()<<std::endl;
-    
-    std::cout<<"\n------------------------------\n"<<std::endl;
-    std::cout<<"\nPrints all of the root to leaf paths in this binary tree.\n"<<std::endl;
-    Tree.flip();
-    Tree.CallDisplay();
-     std::cout<<"\n------We are looking at that above---\n"<<std::endl;
-    Tree.printRootLeaf();
-    std::cout<<"\n------------------------------\n"<<std::endl;
-    
-    std::cout<<"\nTest if this binary tree contains a binary search tree\n"<<std::endl;
-    std::cout<<"\nEnter Number you wish to check for sum : ";
-    int num;
-    std::cin>>num;
-
-    if (Tree.doesSomePathHaveSum(num) == true){
-        std::cout<<"\nThis is a binary tree that contains  the sum for the number "<<num<<std::endl;
-    }
-    else{
-        std::cout<<"\nThis is a binary tree that does not contain sum for the number "<< num<<std::endl;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Reads a whole file (or stdin if path is null) with one fread per
+// megabyte instead of one stream extraction per token.
+bool readAll(const char* path, std::string& contents) {
+    std::FILE* file(path ? std::fopen(path, "rb") : stdin);
+    if (!file) {
+        return false;
+    }
+    static char chunk[1 << 20];
+    std::size_t count;
+    while ( (count = std::fread(chunk, 1, sizeof(chunk), file) ) > 0) {
+        contents.append(chunk, count);
+    }
+    if (path) {
+        std::fclose(file);
+    }
+    return true;
+}
+
+enum class ParseResult { Missing, Parsed, Invalid };
+
+bool isBlank(char c, bool newlines) {
+    return c == ' ' || c == '\t' || c == '\r' || (newlines && c == '\n');
+}
+
+// Parses an optionally signed decimal integer at pos, skipping
+// leading blanks (but not newlines unless skipNewlines). Returns
+// Missing if there is no token, and Invalid if the token is not an
+// integer or does not fit in an int; pos is then left at its start.
+ParseResult parseInt(const std::string& text, std::size_t& pos, int& value, bool skipNewlines) {
+    while (pos < text.size() && isBlank(text[pos], skipNewlines) ) {
+        ++pos;
+    }
+    if (pos >= text.size() || text[pos] == '\n') {
+        return ParseResult::Missing;
+    }
+    std::size_t end(pos);
+    bool negative(false);
+    if (text[end] == '-' || text[end] == '+') {
+        negative = text[end] == '-';
+        ++end;
+    }
+    if (end >= text.size() || text[end] < '0' || text[end] > '9') {
+        return ParseResult::Invalid;
+    }
+    // The bound is checked before each multiply, so the magnitude
+    // never exceeds that of INT_MIN.
+    const unsigned long long limit(negative ? 0ULL - INT_MIN : INT_MAX);
+    unsigned long long magnitude(0);
+    while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+        const unsigned digit(text[end] - '0');
+        if (magnitude > (limit - digit) / 10) {
+            return ParseResult::Invalid;
+        }
+        magnitude = magnitude * 10 + digit;
+        ++end;
+    }
+    if (end < text.size() && !isBlank(text[end], true) ) {
+        return ParseResult::Invalid;
+    }
+    value = negative ? static_cast<int>(0 - static_cast<long long>(magnitude) )
+                     : static_cast<int>(magnitude);
+    pos = end;
+    return ParseResult::Parsed;
+}
+
+// The token at pos, for error messages.
+std::string tokenAt(const std::string& text, std::size_t pos) {
+    auto end(pos);
+    while (end < text.size() && !isBlank(text[end], true) ) {
+        ++end;
+    }
+    return text.substr(pos, end - pos);
+}
+
+void reportPhase(const char* phase, Clock::time_point start) {
+    std::cerr << phase << ": "
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count()
+              << " ms" << std::endl;
+}
+
+int runQuery(BinaryNodeTree<int>& tree, const std::string& line) {
+    std::size_t pos(0);
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t') ) {
+        ++pos;
+    }
+    std::size_t end(pos);
+    while (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r') {
+        ++end;
+    }
+    const std::string command(line, pos, end - pos);
+    if (command.empty() ) {
+        return 0;
+    }
+
+    int argument(0);
+    const auto parsed(parseInt(line, end, argument, false) );
+    const bool hasArgument(parsed == ParseResult::Parsed);
+    std::cout << line << ": ";
+    if (parsed == ParseResult::Invalid) {
+        std::cout << "invalid argument " << tokenAt(line, end) << '\n';
+        return 0;
+    }
+
+    if (command == "contains" && hasArgument) {
+        std::cout << (tree.contains(argument) ? "yes" : "no");
+    }
+    else if (command == "pathsum" && hasArgument) {
+        auto found(tree.tryDoesSomePathHaveSum(argument) );
+        std::cout << (found && *found ? "yes" : "no");
+    }
+    else if (command == "downsum" && hasArgument) {
+        std::cout << tree.countDownwardPathSums(static_cast<long long>(argument) );
+    }
+    else if (command == "min" || command == "max") {
+        auto extreme(command == "min" ? tree.tryGetMin() : tree.tryGetMax() );
+        if (extreme) {
+            std::cout << *extreme;
+        }
+        else {
+            std::cout << "empty";
+        }
+    }
+    else if (command == "bst") {
+        std::cout << (tree.BST() ? "yes" : "no");
+    }
+    else if (command == "height") {
+        std::cout << tree.getHeight();
+    }
+    else if (command == "size") {
+        std::cout << tree.getNumberOfNodes();
+    }
+    else if (command == "paths") {
+        std::cout << '\n';
+        tree.tryPrintRootLeaf();
+        return 1;
+    }
+    else {
+        std::cout << "unknown query" << '\n';
+        return 0;
+    }
+    std::cout << '\n';
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* itemsPath(nullptr);
+    const char* queriesPath(nullptr);
+    for (int arg(1); arg < argc; ++arg) {
+        if (std::strcmp(argv[arg], "-i") == 0 && arg + 1 < argc) {
+            itemsPath = argv[++arg];
+        }
+        else if (std::strcmp(argv[arg], "-q") == 0 && arg + 1 < argc) {
+            queriesPath = argv[++arg];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [-i itemsFile] [-q queriesFile]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Answers are collected in a large buffer and written in blocks.
+    static char outputBuffer[1 << 20];
+    std::ios::sync_with_stdio(false);
+    std::cout.rdbuf()->pubsetbuf(outputBuffer, sizeof(outputBuffer) );
+
+    auto start(Clock::now() );
+    std::string itemsText;
+    if (!readAll(itemsPath, itemsText) ) {
+        std::cerr << "Cannot read items from " << itemsPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    reportPhase("read items", start);
+
+    start = Clock::now();
+    std::vector<int> items;
+    std::size_t pos(0);
+    int item;
+    ParseResult parsed;
+    while ( (parsed = parseInt(itemsText, pos, item, true) ) == ParseResult::Parsed) {
+        items.push_back(item);
+    }
+    if (parsed == ParseResult::Invalid) {
+        std::cerr << "Invalid item " << tokenAt(itemsText, pos)
+                  << " (items must be integers in int range)" << std::endl;
+        return EXIT_FAILURE;
+    }
+    reportPhase("parse items", start);
+
+    start = Clock::now();
+    BinaryNodeTree<int> tree;
+    tree.buildFromAdds(items.begin(), items.end() );
+    // The tree is not modified after this, so contains, min and max
+    // can scan the flat snapshot instead of walking the nodes.
+    tree.flatten();
+    reportPhase("build tree", start);
+    std::cerr << "items: " << items.size() << ", height: " << tree.getHeight() << std::endl;
+
+    if (queriesPath) {
+        start = Clock::now();
+        std::string queriesText;
+        if (!readAll(queriesPath, queriesText) ) {
+            std::cerr << "Cannot read queries from " << queriesPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::size_t answered(0);
+        for (std::size_t lineStart(0); lineStart < queriesText.size(); ) {
+            auto lineEnd(queriesText.find('\n', lineStart) );
+            if (lineEnd == std::string::npos) {
+                lineEnd = queriesText.size();
+            }
+            auto contentEnd(lineEnd);
+            if (contentEnd > lineStart && queriesText[contentEnd - 1] == '\r') {
+                --contentEnd;
+            }
+            answered += runQuery(tree, queriesText.substr(lineStart, contentEnd - lineStart) );
+            lineStart = lineEnd + 1;
+        }
+        std::cout.flush();
+        reportPhase("queries", start);
+        std::cerr << "queries answered: " << answered << std::endl;
     }
+    std::cout.flush();
     return EXIT_SUCCESS;
-    
 }
@@ -0,0 +1,120 @@
+//
+//  readBench.cpp
+//  Project7
+//
+//  Created by Rudolf Musika on 4/17/18.
+//  Copyright © 2018 Rudolf Musika. All rights reserved.
+//
+//  Concurrent read benchmark: 1 to maxThreads threads share one tree
+//  and only call const methods on it, so any slowdown as threads are
+//  added comes from the threads contending for shared memory, such as
+//  reference counts written on the read paths.
+//
+//  Usage: readBench [items] [maxThreads] [lookupsPerThread]
+//
+//  Defaults: 50000 items, 8 threads, 1000 lookups. The tree is not a
+//  search tree, so each lookup walks in preorder until it finds the
+//  key. For each thread count it prints the wall time and total
+//  throughput of two workloads:
+//
+//      contains   random lookups, about half of them misses
+//      walk       getNumberOfNodes, one full walk per 20 lookups
+//
+//  Build with -pthread.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "BinaryNodeTree.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Starts threads workers together and returns the wall time in ms
+// until the last one finishes.
+template <typename Work>
+double runThreads(int threads, Work work) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int thread(0); thread < threads; ++thread) {
+        workers.emplace_back([&, thread]() {
+            ++ready;
+            while (!go.load(std::memory_order_acquire) ) {
+                std::this_thread::yield();
+            }
+            work(thread);
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    const auto start(Clock::now() );
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+long argumentOr(int argc, char* argv[], int index, long fallback) {
+    return argc > index ? std::strtol(argv[index], nullptr, 10) : fallback;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const long items(argumentOr(argc, argv, 1, 50000) );
+    const long maxThreads(argumentOr(argc, argv, 2, 8) );
+    const long lookups(argumentOr(argc, argv, 3, 1000) );
+    if (argc > 4 || items <= 0 || maxThreads <= 0 || lookups <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [items] [maxThreads] [lookupsPerThread]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Even items only, so that odd keys miss.
+    std::mt19937 random(1);
+    std::vector<int> values(items);
+    for (auto& value : values) {
+        value = static_cast<int>(random() % (4 * items) ) & ~1;
+    }
+    BinaryNodeTree<int> tree;
+    tree.buildFromAdds(values.begin(), values.end() );
+    const BinaryNodeTree<int>& shared(tree);
+
+    const long walks(lookups / 20 > 0 ? lookups / 20 : 1);
+    std::atomic<long> sink(0);
+    std::cout << "items " << items << ", height " << tree.getHeight()
+              << ", hardware threads " << std::thread::hardware_concurrency() << '\n';
+    std::cout << "threads  contains ms  lookups/s   walk ms  Mnodes/s\n";
+    for (long threads(1); threads <= maxThreads; threads *= 2) {
+        const double containsMs(runThreads(static_cast<int>(threads), [&](int thread) {
+            std::mt19937 keys(thread + 2);
+            long hits(0);
+            for (long lookup(0); lookup < lookups; ++lookup) {
+                hits += shared.contains(static_cast<int>(keys() % (4 * items) ) );
+            }
+            sink += hits;
+        }) );
+        const double walkMs(runThreads(static_cast<int>(threads), [&](int) {
+            long nodes(0);
+            for (long walk(0); walk < walks; ++walk) {
+                nodes += shared.getNumberOfNodes();
+            }
+            sink += nodes;
+        }) );
+        std::printf("%7ld  %11.1f  %9.0f  %8.1f  %8.2f\n", threads,
+                    containsMs, threads * lookups / containsMs * 1000.0,
+                    walkMs, threads * walks * items / walkMs / 1000.0);
+    }
+    // Printed so that the lookups cannot be optimized away.
+    std::cerr << "checksum " << sink.load() << std::endl;
+    return EXIT_SUCCESS;
+}
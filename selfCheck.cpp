@@ -0,0 +1,363 @@
+//
+//  selfCheck.cpp
+//  Project7
+//
+//  Created by Rudolf Musika on 4/17/18.
+//  Copyright © 2018 Rudolf Musika. All rights reserved.
+//
+//  Round-trip checks for the on-disk formats of DurableBinaryTree and
+//  PagedBinaryTree, so that a change to them cannot break recovery or
+//  reopening unnoticed, and a check that keyed lookups (see
+//  LookupTraits.h) work on a record type with no std::hash.
+//
+//  Usage: selfCheck [scratchDirectory]
+//
+//  The files are created in scratchDirectory, or else in the system
+//  temporary directory, and removed afterwards. Each check prints
+//  "name: ok" or the failed conditions. The exit status is non-zero
+//  if any check failed.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "BinaryNodeTree.h"
+#include "DurableBinaryTree.h"
+#include "PagedBinaryTree.h"
+
+// The record of the LookupTraits.h example: looked up by name, with
+// no std::hash<Employee> and no operator< anywhere.
+struct Employee {
+    std::string name;
+    int id;
+};
+
+bool operator==(const Employee& lhs, const Employee& rhs) {
+    return lhs.name == rhs.name && lhs.id == rhs.id;
+}
+
+template <>
+struct LookupTraits<Employee> : KeyLookup<std::string> {
+    static const std::string& keyOf(const Employee& employee) {
+        return employee.name;
+    }
+};
+
+namespace {
+
+std::string scratch;
+int failures(0);
+
+void expect(bool condition, const char* check, const char* what) {
+    if (!condition) {
+        std::cout << check << ": FAILED " << what << '\n';
+        ++failures;
+    }
+}
+
+std::vector<int> preorderOf(const BinaryNodeTree<int>& tree) {
+    std::vector<int> items;
+    tree.exportPreorder(std::back_inserter(items) );
+    return items;
+}
+
+void removeFiles(const std::string& base, std::initializer_list<const char*> suffixes) {
+    for (auto suffix : suffixes) {
+        std::remove( (base + suffix).c_str() );
+    }
+}
+
+// Appends raw bytes to a file, as a crash part way through a write
+// would leave them.
+void appendBytes(const std::string& path, const void* bytes, std::size_t count) {
+    std::FILE* file(std::fopen(path.c_str(), "ab") );
+    if (file) {
+        std::fwrite(bytes, 1, count, file);
+        std::fclose(file);
+    }
+}
+
+// Mixed mutations with a checkpoint in the middle, so that recovery
+// has to load the checkpoint and then replay the journal after it. A
+// journal from before a later checkpoint must then be ignored.
+void checkDurableRecovery(const char* name) {
+    const std::string base(scratch + "/selfCheck.durable");
+    removeFiles(base, {".journal", ".checkpoint"});
+
+    std::mt19937 random(3);
+    BinaryNodeTree<int> expected;
+    {
+        DurableBinaryTree<int> durable(base, 16);
+        for (int step(0); step < 500; ++step) {
+            const int kind(random() % 10);
+            const int item(random() % 100);
+            if (kind < 6) {
+                durable.add(item);
+                expected.add(item);
+            }
+            else if (kind < 8) {
+                durable.remove(item);
+                expected.remove(item);
+            }
+            else if (kind < 9) {
+                if (!expected.isEmpty() ) {
+                    durable.setRootData(item);
+                    expected.setRootData(item);
+                }
+            }
+            else {
+                durable.flip();
+                expected.flip();
+            }
+            if (step == 200) {
+                durable.checkpoint();
+            }
+        }
+    }
+    {
+        DurableBinaryTree<int> durable(base, 16);
+        expect(durable.getTree() == expected, name, "recovered tree differs");
+        expect(preorderOf(durable.getTree() ) == preorderOf(expected), name, "recovered preorder differs");
+        expect(durable.getTree().hash() == expected.hash(), name, "recovered hash differs");
+        durable.add(-1);
+        expected.add(-1);
+    }
+
+    // Keep the journal, checkpoint, then put the old journal back.
+    std::filesystem::copy_file(base + ".journal", base + ".stale",
+                               std::filesystem::copy_options::overwrite_existing);
+    {
+        DurableBinaryTree<int> durable(base, 16);
+        durable.checkpoint();
+    }
+    std::filesystem::rename(base + ".stale", base + ".journal");
+    {
+        DurableBinaryTree<int> durable(base, 16);
+        expect(durable.getTree() == expected, name, "stale journal was replayed");
+    }
+    removeFiles(base, {".journal", ".checkpoint", ".stale"});
+}
+
+// A torn batch (its header promises more bytes than were written) and
+// a damaged one (its checksum does not match) must both be dropped on
+// recovery, and the journal cut back so that later batches are not
+// stranded behind them.
+void checkTornBatch(const char* name) {
+    const std::string base(scratch + "/selfCheck.torn");
+    removeFiles(base, {".journal", ".checkpoint"});
+
+    BinaryNodeTree<int> expected;
+    {
+        DurableBinaryTree<int> durable(base, 4);
+        for (int item(0); item < 10; ++item) {
+            durable.add(item);
+            expected.add(item);
+        }
+    }
+
+    // Batch header: u32 records, u32 bytes, u64 checksum. The record
+    // is an Add of 12345.
+    unsigned char batch[16 + 1 + sizeof(int)] = {};
+    const std::uint32_t records(1);
+    const std::uint32_t bytes(1 + sizeof(int) );
+    const int item(12345);
+    std::memcpy(batch, &records, sizeof(records) );
+    std::memcpy(batch + 4, &bytes, sizeof(bytes) );
+    batch[16] = static_cast<unsigned char>(DurableBinaryTree<int>::Op::Add);
+    std::memcpy(batch + 17, &item, sizeof(item) );
+
+    // Whole, but with a wrong checksum.
+    appendBytes(base + ".journal", batch, sizeof(batch) );
+    {
+        DurableBinaryTree<int> durable(base, 4);
+        expect(durable.getTree() == expected, name, "damaged batch was replayed");
+        durable.add(10);
+        expected.add(10);
+    }
+    {
+        DurableBinaryTree<int> durable(base, 4);
+        expect(durable.getTree() == expected, name, "batch after a damaged one was lost");
+    }
+
+    // Cut off part way through its records.
+    appendBytes(base + ".journal", batch, sizeof(batch) - 2);
+    {
+        DurableBinaryTree<int> durable(base, 4);
+        expect(durable.getTree() == expected, name, "torn batch was replayed");
+        durable.add(11);
+        expected.add(11);
+    }
+    {
+        DurableBinaryTree<int> durable(base, 4);
+        expect(durable.getTree() == expected, name, "batch after a torn one was lost");
+        expect(!durable.getTree().contains(12345), name, "torn record applied");
+    }
+    removeFiles(base, {".journal", ".checkpoint"});
+}
+
+std::vector<int> preorderOf(PagedBinaryTree<int>& tree) {
+    std::vector<int> items;
+    tree.preorderTraverse([&items](int item) { items.push_back(item); });
+    return items;
+}
+
+std::vector<int> inorderOf(PagedBinaryTree<int>& tree) {
+    std::vector<int> items;
+    tree.inorderTraverse([&items](int item) { items.push_back(item); });
+    return items;
+}
+
+// Builds a paged tree with small pages and a cache too small to hold
+// it, so pages are evicted and written back, then reopens the file
+// with a different cache size. The reopened tree must keep its page
+// size, shape and items, through add, load and clear.
+void checkPagedReopen(const char* name) {
+    const std::string path(scratch + "/selfCheck.paged");
+    std::remove(path.c_str() );
+
+    std::mt19937 random(5);
+    BinaryNodeTree<int> expected;
+    std::size_t slotsPerPage(0);
+    {
+        PagedBinaryTree<int> paged(path, 2, 256);
+        for (int step(0); step < 1500; ++step) {
+            const int item(random() % 100000);
+            paged.add(item);
+            expected.add(item);
+        }
+        paged.setRootData(-7);
+        expected.setRootData(-7);
+        slotsPerPage = paged.getSlotsPerPage();
+    }
+    {
+        PagedBinaryTree<int> paged(path, 5);
+        expect(paged.getSlotsPerPage() == slotsPerPage, name, "page size not kept");
+        expect(paged.getRootData() == -7, name, "root not kept");
+        expect(paged.getNumberOfNodes() == expected.getNumberOfNodes(), name, "node count not kept");
+        expect(preorderOf(paged) == preorderOf(expected), name, "reopened preorder differs");
+        for (int step(0); step < 100; ++step) {
+            const int item(random() % 100000);
+            paged.add(item);
+            expected.add(item);
+        }
+        expect(preorderOf(paged) == preorderOf(expected), name, "add after reopen differs");
+
+        // A flipped tree is stored as it reads, so load must unflip.
+        expected.flip();
+        paged.load(expected);
+    }
+    {
+        PagedBinaryTree<int> paged(path, 3);
+        std::vector<int> inorder;
+        expected.exportInorder(std::back_inserter(inorder) );
+        expect(preorderOf(paged) == preorderOf(expected), name, "loaded preorder differs");
+        expect(inorderOf(paged) == inorder, name, "loaded inorder differs");
+        expect(paged.getHeight() == expected.getHeight(), name, "loaded height differs");
+        paged.clear();
+    }
+    {
+        PagedBinaryTree<int> paged(path, 1);
+        expect(paged.isEmpty() && preorderOf(paged).empty(), name, "cleared tree not empty");
+    }
+    std::remove(path.c_str() );
+}
+
+// Every keyed structure (ancestor index, membership filter, adaptive
+// layout) must work from the name alone.
+void checkRecordLookup(const char* name) {
+    BinaryNodeTree<Employee> staff;
+    for (const auto& employee : {Employee{"Ada", 1}, Employee{"Grace", 2},
+                                 Employee{"Linus", 3}, Employee{"Barbara", 4}}) {
+        staff.add(employee);
+    }
+    expect(staff.contains("Ada") && !staff.contains("Bob"), name, "contains by name");
+    expect(staff.getEntry(Employee{"Grace", 0}).id == 2, name, "getEntry by name");
+    expect(staff.tryGetEntry(std::string("Linus") )->id == 3, name, "tryGetEntry by name");
+    expect(staff.lowestCommonAncestor(Employee{"Linus", 0}, Employee{"Barbara", 0}).name == "Ada",
+           name, "lowestCommonAncestor by name");
+
+    staff.enableMembershipFilter(16);
+    expect(staff.contains("Barbara") && !staff.contains("Zed"), name, "filtered contains");
+
+    staff.enableAdaptiveLayout(4);
+    for (int lookup(0); lookup < 8; ++lookup) {
+        staff.contains("Barbara");
+    }
+    expect(staff.getRootData().name == "Barbara", name, "hot name not promoted");
+
+    BinaryNodeTree<Employee> copy(staff);
+    expect(copy == staff && copy.diff(staff).empty(), name, "copy differs");
+    expect(staff.remove(Employee{"Ada", 1}) && !staff.contains("Ada"), name, "remove by name");
+    expect(copy.contains("Ada"), name, "copy changed by remove");
+}
+
+// A promoted key keeps half its hits into the next period, so a
+// quiet period must not promote the item it displaced back over it.
+void checkAdaptiveAging(const char* name) {
+    BinaryNodeTree<int> tree;
+    for (int item(0); item < 64; ++item) {
+        tree.add(item);
+    }
+    tree.enableAdaptiveLayout(100);
+    for (int lookup(0); lookup < 100; ++lookup) {
+        tree.contains(50);
+    }
+    expect(tree.getRootData() == 50, name, "hot key not promoted");
+
+    tree.contains(7);
+    for (int lookup(0); lookup < 99; ++lookup) {
+        tree.contains(1000 + lookup);
+    }
+    expect(tree.getRootData() == 50, name, "aged count went to a displaced key");
+    for (int item(0); item < 64; ++item) {
+        expect(tree.contains(item), name, "item lost by promotion");
+    }
+}
+
+struct Check {
+    const char* name;
+    void (*run)(const char* name);
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [scratchDirectory]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    scratch = argc == 2 ? std::string(argv[1])
+                        : std::filesystem::temp_directory_path().string();
+
+    const Check checks[] = {
+        {"durable checkpoint + journal replay", checkDurableRecovery},
+        {"durable torn batch", checkTornBatch},
+        {"paged reopen", checkPagedReopen},
+        {"record lookup", checkRecordLookup},
+        {"adaptive aging", checkAdaptiveAging},
+    };
+    for (const auto& check : checks) {
+        const int failuresBefore(failures);
+        try {
+            check.run(check.name);
+        }
+        catch (const std::exception& error) {
+            std::cout << check.name << ": FAILED " << error.what() << '\n';
+            ++failures;
+        }
+        if (failures == failuresBefore) {
+            std::cout << check.name << ": ok" << '\n';
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}